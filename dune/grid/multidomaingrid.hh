@@ -4,6 +4,11 @@
 #include <dune/common/parallel/communication.hh>
 #include <dune/grid/multidomaingrid/multidomaingrid.hh>
 #include <dune/grid/multidomaingrid/multidomainmcmgmapper.hh>
+#include <dune/grid/multidomaingrid/interfacemcmgmapper.hh>
+#include <dune/grid/multidomaingrid/monolithicmcmgmapper.hh>
+#include <dune/grid/multidomaingrid/elementpartition.hh>
+#include <dune/grid/multidomaingrid/subdomaininterfacerange.hh>
+#include <dune/grid/multidomaingrid/interfacequadraturecache.hh>
 #include <dune/grid/multidomaingrid/factory.hh>
 #include <dune/grid/multidomaingrid/gmshreader.hh>
 
@@ -11,6 +16,8 @@ namespace Dune {
 
 using mdgrid::MultiDomainGrid;
 using mdgrid::MultiDomainMCMGMapper;
+using mdgrid::InterfaceMCMGMapper;
+using mdgrid::MonolithicMCMGMapper;
 
 
 namespace Capabilities {
@@ -12,6 +12,8 @@
 
 #include <dune/common/exceptions.hh>
 
+#include <dune/grid/multidomaingrid/subdomainsetencoding.hh>
+
 namespace Dune {
 
 namespace mdgrid {
@@ -50,9 +52,10 @@ public:
 
   enum SetState {emptySet,simpleSet,multipleSet};
 
+  //! Communicates the set in the delta and varint encoding of util::encodeSubDomains().
   struct DataHandle
   {
-    typedef SubDomainIndex DataType;
+    typedef unsigned char DataType;
 
     static bool fixedSize(int dim, int codim)
     {
@@ -61,24 +64,25 @@ public:
 
     static std::size_t size(const ArrayBasedSet& sds)
     {
-      return sds.size();
+      return util::encodedSubDomainsSize(sds);
     }
 
     template<typename MessageBufferImp>
     static void gather(MessageBufferImp& buf, const ArrayBasedSet& sds)
     {
-      for(Iterator it = sds.begin(); it != sds.end(); ++it)
-        buf.write(*it);
+      util::encodeSubDomains(sds,[&](DataType byte) { buf.write(byte); });
     }
 
     template<typename MessageBufferImp>
     static void scatter(MessageBufferImp& buf, ArrayBasedSet& sds, std::size_t n)
     {
       ArrayBasedSet h;
-      h._size = n;
-      ArrayIterator end = h._set.begin() + n;
-      for (ArrayIterator it = h._set.begin(); it != end; ++it)
-        buf.read(*it);
+      util::decodeSubDomains<SubDomainIndex>(n,
+                                             [&]() { DataType byte; buf.read(byte); return byte; },
+                                             [&](SubDomainIndex subDomain) {
+                                               assert(h._size < maxSize);
+                                               h._set[h._size++] = subDomain;
+                                             });
       sds.addAll(h);
     }
 
@@ -201,7 +205,7 @@ inline void setAdd(ArrayBasedSet<SubDomainIndex,capacity>& a,
                                                                                    tmp.begin());
   a._size = it - tmp.begin();
   assert(a._size <= capacity);
-  std::copy(tmp.begin(),++it,a._set.begin());
+  std::copy(tmp.begin(),it,a._set.begin());
 }
 
 } // namespace mdgrid
@@ -0,0 +1,196 @@
+#ifndef DUNE_MULTIDOMAINGRID_ELEMENTPARTITION_HH
+#define DUNE_MULTIDOMAINGRID_ELEMENTPARTITION_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/multidomaingrid/utility.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+//! Splits the elements of a grid view into contiguous chunks for thread-parallel processing.
+/**
+ * The iterators of MultiDomainGrid and SubDomainGrid views are forward iterators, and the
+ * iterators of SubDomainGrid views additionally skip all cells outside of the subdomain, so
+ * they cannot be used to hand out work to multiple threads. ElementPartition traverses the
+ * grid view once and stores the seeds of all elements in iteration order. These seeds are then
+ * split into the requested number of chunks, whose sizes differ by at most one element.
+ * Each thread can turn the seeds of its chunk back into entities by calling entity().
+ *
+ * Optionally, the chunks can be colored such that no two chunks of the same color contain
+ * elements that share a vertex. All chunks of a single color can then be processed concurrently
+ * while scattering into global vectors indexed by vertices, edges, faces or elements without
+ * further synchronization.
+ *
+ * The partition stores entity seeds and thus remains valid until the grid (or, for
+ * SubDomainGrids, the subdomain layout) is modified.
+ *
+ * \tparam GV      the grid view, either of a MultiDomainGrid or of a SubDomainGrid.
+ * \tparam pitype  the partition of the grid view that should be split.
+ */
+template<typename GV, PartitionIteratorType pitype = All_Partition>
+class ElementPartition
+{
+
+public:
+
+  typedef GV GridView;
+  typedef typename GV::template Codim<0>::Entity Entity;
+  typedef typename Entity::EntitySeed EntitySeed;
+
+  //! A single chunk, given as a range of entity seeds.
+  typedef util::Span<const EntitySeed> Chunk;
+
+  static const int dimension = GV::dimension;
+
+  //! Splits the elements of gv into the given number of chunks.
+  /**
+   * \param gv       the grid view.
+   * \param chunks   the requested number of chunks. If the grid view has fewer elements,
+   *                 the number of chunks is reduced accordingly.
+   * \param colored  if true, the chunks will be colored, see colors().
+   */
+  ElementPartition(const GV& gv, std::size_t chunks, bool colored = false)
+    : _gridView(gv)
+  {
+    _seeds.reserve(gv.size(0));
+    auto end = gv.template end<0,pitype>();
+    for (auto it = gv.template begin<0,pitype>(); it != end; ++it)
+      _seeds.push_back(it->seed());
+
+    const std::size_t n = _seeds.size();
+    chunks = std::min(chunks,n);
+    _chunkOffsets.assign(chunks + 1,0);
+    for (std::size_t i = 1; i <= chunks; ++i)
+      _chunkOffsets[i] = (i * n) / chunks;
+
+    if (colored)
+      color();
+  }
+
+  const GridView& gridView() const {
+    return _gridView;
+  }
+
+  //! Returns the number of chunks.
+  std::size_t size() const {
+    return _chunkOffsets.empty() ? 0 : _chunkOffsets.size() - 1;
+  }
+
+  //! Returns the seeds of the elements in chunk i.
+  Chunk operator[](std::size_t i) const {
+    return Chunk(_seeds.data() + _chunkOffsets[i],_seeds.data() + _chunkOffsets[i+1]);
+  }
+
+  //! Returns the element with the given seed.
+  Entity entity(const EntitySeed& seed) const {
+    return _gridView.grid().entity(seed);
+  }
+
+  //! Returns the total number of elements in all chunks.
+  std::size_t elementCount() const {
+    return _seeds.size();
+  }
+
+  //! Returns whether the chunks have been colored.
+  bool colored() const {
+    return !_colorOffsets.empty();
+  }
+
+  //! Returns the number of colors.
+  std::size_t colors() const {
+    return _colorOffsets.empty() ? 0 : _colorOffsets.size() - 1;
+  }
+
+  //! Returns the color of chunk i.
+  std::size_t color(std::size_t i) const {
+    return _chunkColors[i];
+  }
+
+  //! Returns the numbers of all chunks with color c.
+  util::Span<const std::size_t> chunksWithColor(std::size_t c) const {
+    return util::Span<const std::size_t>(_coloredChunks.data() + _colorOffsets[c],_coloredChunks.data() + _colorOffsets[c+1]);
+  }
+
+  //! Colors the chunks such that chunks of the same color do not share any vertices.
+  /**
+   * This uses a greedy coloring of the chunk conflict graph in chunk order, which needs few
+   * colors for the contiguous chunks created by grid traversal.
+   */
+  void color() {
+    const auto& indexSet = _gridView.indexSet();
+    const std::size_t chunks = size();
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    // collect the chunks adjacent to each vertex
+    std::vector<std::vector<std::size_t> > vertexChunks(indexSet.size(dimension));
+    for (std::size_t c = 0; c < chunks; ++c)
+      for (const auto& seed : (*this)[c]) {
+        const Entity e = entity(seed);
+        const unsigned int corners = e.subEntities(dimension);
+        for (unsigned int i = 0; i < corners; ++i) {
+          auto& adjacentChunks = vertexChunks[indexSet.subIndex(e,i,dimension)];
+          if (adjacentChunks.empty() || adjacentChunks.back() != c)
+            adjacentChunks.push_back(c);
+        }
+      }
+
+    // build conflict graph
+    std::vector<std::vector<std::size_t> > conflicts(chunks);
+    for (const auto& adjacentChunks : vertexChunks)
+      for (std::size_t a : adjacentChunks)
+        for (std::size_t b : adjacentChunks)
+          if (a != b)
+            conflicts[a].push_back(b);
+
+    // greedy coloring
+    _chunkColors.assign(chunks,none);
+    std::size_t colorCount = 0;
+    std::vector<std::size_t> usedBy;
+    for (std::size_t c = 0; c < chunks; ++c) {
+      usedBy.assign(colorCount + 1,none);
+      for (std::size_t neighbor : conflicts[c])
+        if (_chunkColors[neighbor] != none)
+          usedBy[_chunkColors[neighbor]] = c;
+      std::size_t col = 0;
+      while (usedBy[col] == c)
+        ++col;
+      _chunkColors[c] = col;
+      colorCount = std::max(colorCount,col + 1);
+    }
+
+    // sort chunks by color
+    _colorOffsets.assign(colorCount + 1,0);
+    for (std::size_t c = 0; c < chunks; ++c)
+      ++_colorOffsets[_chunkColors[c] + 1];
+    for (std::size_t col = 0; col < colorCount; ++col)
+      _colorOffsets[col + 1] += _colorOffsets[col];
+    _coloredChunks.resize(chunks);
+    std::vector<std::size_t> position(_colorOffsets.begin(),_colorOffsets.end() - 1);
+    for (std::size_t c = 0; c < chunks; ++c)
+      _coloredChunks[position[_chunkColors[c]]++] = c;
+  }
+
+private:
+
+  GridView _gridView;
+  std::vector<EntitySeed> _seeds;
+  std::vector<std::size_t> _chunkOffsets;
+
+  std::vector<std::size_t> _chunkColors;
+  std::vector<std::size_t> _colorOffsets;
+  std::vector<std::size_t> _coloredChunks;
+
+};
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_ELEMENTPARTITION_HH
@@ -0,0 +1,411 @@
+#ifndef DUNE_MULTIDOMAINGRID_GLOBALSUBDOMAININDICES_HH
+#define DUNE_MULTIDOMAINGRID_GLOBALSUBDOMAININDICES_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/common/capabilities.hh>
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+//! Process-wide consistent subdomain indices of the leaf index set of a MultiDomainGrid.
+/**
+ * For every subdomain and codimension, the entities of the subdomain are numbered
+ * consecutively across all processes. Every entity is owned by exactly one process: interior
+ * entities by the local process, border entities by the lowest rank that has them as interior
+ * or border entities. Each process numbers its owned entities in the order of its local
+ * subdomain indices, starting at the sum of the owned entities of all lower ranks. The indices
+ * of the remaining entities, including overlap and ghost entities, are received from their
+ * owners.
+ *
+ * Indices are only computed for codimensions that are supported by the MDGridTraits and for
+ * which the host grid can communicate.
+ *
+ * \note This class is used internally by IndexSetWrapper, see
+ *       MultiDomainGrid::setGlobalSubDomainIndexing().
+ */
+template<typename IndexSet>
+class GlobalSubDomainIndices
+{
+
+public:
+
+  typedef typename IndexSet::IndexType IndexType;
+  typedef typename IndexSet::SubDomainIndex SubDomainIndex;
+  typedef typename IndexSet::GlobalIndexType GlobalIndexType;
+
+  static const int dimension = IndexSet::dimension;
+
+  //! Returns whether global indices have been computed.
+  bool valid() const
+  {
+    return _valid;
+  }
+
+  //! Returns whether global indices are available for the given codimension.
+  bool contains(int codim) const
+  {
+    return _valid && _codims[codim].enabled;
+  }
+
+  //! Returns the global index of the entity with the given local subdomain index.
+  GlobalIndexType index(SubDomainIndex subDomain, int codim, std::size_t typeIndex, IndexType localIndex) const
+  {
+    assert(contains(codim));
+    const CodimData& c = _codims[codim];
+    return c.values[c.offsets[slot(subDomain) * c.types + typeIndex] + localIndex];
+  }
+
+  //! Returns the number of entities of the given codimension in subDomain across all processes.
+  GlobalIndexType size(SubDomainIndex subDomain, int codim) const
+  {
+    auto it = std::lower_bound(_sizes.begin(),_sizes.end(),subDomain,
+                               [](const std::pair<SubDomainIndex,Sizes>& entry, SubDomainIndex s) {
+                                 return entry.first < s;
+                               });
+    if (it == _sizes.end() || it->first != subDomain)
+      return 0;
+    return it->second[codim];
+  }
+
+  void clear()
+  {
+    _valid = false;
+    _codims = std::array<CodimData,dimension+1>();
+    _slots.clear();
+    _sizes.clear();
+  }
+
+  //! Computes the global indices for the current subdomain layout of indexSet, which is a collective operation.
+  void update(const IndexSet& indexSet)
+  {
+    clear();
+    const auto& hostGridView = indexSet._hostGridView;
+    const auto& hostIndexSet = hostGridView.indexSet();
+    const auto& comm = hostGridView.comm();
+    const int rank = comm.rank();
+
+    const auto& subDomains = indexSet.activeSubDomains();
+    _slots.assign(subDomains.empty() ? 0 : subDomains.back() + 1,noSlot);
+    for (std::size_t s = 0; s < subDomains.size(); ++s)
+      _slots[subDomains[s]] = s;
+
+    // interior and border entities are candidates for ownership
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        if constexpr (enabled<codim>()) {
+          CodimData& c = _codims[codim];
+          c.enabled = true;
+          c.types = LocalGeometryTypeIndex::size(dimension - codim);
+          c.owners.resize(c.types);
+          for (auto gt : hostIndexSet.types(codim))
+            c.owners[LocalGeometryTypeIndex::index(gt)].assign(hostIndexSet.size(gt),-1);
+        }
+      });
+    for (const auto& he : elements(hostGridView)) {
+      Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+          if constexpr (enabled<codim>()) {
+            const unsigned int count = he.subEntities(codim);
+            for (unsigned int i = 0; i < count; ++i) {
+              const auto se = he.template subEntity<codim>(i);
+              const PartitionType pt = se.partitionType();
+              if (pt == InteriorEntity || pt == BorderEntity)
+                _codims[codim].owners[LocalGeometryTypeIndex::index(se.type())][hostIndexSet.index(se)] = rank;
+            }
+          }
+        });
+    }
+    if (comm.size() > 1) {
+      OwnerDataHandle dh(*this,indexSet);
+      hostGridView.communicate(dh,InteriorBorder_InteriorBorder_Interface,ForwardCommunication);
+    }
+
+    // count the owned entities of every subdomain
+    const std::size_t recordSize = dimension + 2;
+    std::vector<GlobalIndexType> counts(subDomains.size() * recordSize,0);
+    for (std::size_t s = 0; s < subDomains.size(); ++s)
+      counts[s * recordSize] = subDomains[s];
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        if constexpr (enabled<codim>()) {
+          const CodimData& c = _codims[codim];
+          const auto& indexMap = indexSet.template indexMap<codim>();
+          for (std::size_t t = 0; t < c.types; ++t)
+            for (std::size_t i = 0; i < c.owners[t].size(); ++i)
+              if (c.owners[t][i] == rank)
+                for (const auto& subDomain : indexMap[t][i].domains)
+                  ++counts[_slots[subDomain] * recordSize + 1 + codim];
+        }
+      });
+
+    // gather the counts of all ranks and compute the first index of every subdomain on this rank
+    int length = counts.size();
+    std::vector<int> lengths(comm.size());
+    comm.allgather(&length,1,lengths.data());
+    std::vector<int> displacements(comm.size() + 1,0);
+    std::partial_sum(lengths.begin(),lengths.end(),displacements.begin() + 1);
+    std::vector<GlobalIndexType> allCounts(displacements.back());
+    comm.allgatherv(counts.data(),length,allCounts.data(),lengths.data(),displacements.data());
+
+    std::vector<Sizes> first(subDomains.size(),Sizes());
+    std::map<SubDomainIndex,Sizes> sizes;
+    for (int r = 0; r < comm.size(); ++r)
+      for (int k = displacements[r]; k < displacements[r+1]; k += recordSize) {
+        const SubDomainIndex subDomain = allCounts[k];
+        Sizes& total = sizes.emplace(subDomain,Sizes()).first->second;
+        const std::size_t s = r < rank ? slot(subDomain) : noSlot;
+        for (int codim = 0; codim <= dimension; ++codim) {
+          total[codim] += allCounts[k + 1 + codim];
+          if (s != noSlot)
+            first[s][codim] += allCounts[k + 1 + codim];
+        }
+      }
+    _sizes.assign(sizes.begin(),sizes.end());
+
+    // number the owned entities
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        if constexpr (enabled<codim>()) {
+          CodimData& c = _codims[codim];
+          const auto& sizeMap = indexSet.template sizeMap<codim>();
+          c.offsets.assign(subDomains.size() * c.types + 1,0);
+          for (std::size_t s = 0; s < subDomains.size(); ++s)
+            for (std::size_t t = 0; t < c.types; ++t)
+              if (t < sizeMap.size() && !sizeMap[t].empty())
+                c.offsets[s * c.types + t + 1] = sizeMap[t][subDomains[s]];
+          std::partial_sum(c.offsets.begin(),c.offsets.end(),c.offsets.begin());
+          c.values.assign(c.offsets.back(),invalid);
+          std::vector<GlobalIndexType> next(subDomains.size());
+          for (std::size_t s = 0; s < subDomains.size(); ++s)
+            next[s] = first[s][codim];
+          const auto& indexMap = indexSet.template indexMap<codim>();
+          for (std::size_t t = 0; t < c.types; ++t)
+            for (std::size_t i = 0; i < c.owners[t].size(); ++i)
+              if (c.owners[t][i] == rank)
+                for (const auto& subDomain : indexMap[t][i].domains) {
+                  const std::size_t s = _slots[subDomain];
+                  c.values[c.offsets[s * c.types + t] + localIndex<codim>(indexSet,indexMap[t][i],subDomain)] = next[s]++;
+                }
+        }
+      });
+
+    // send the indices of owned entities to all copies
+    if (comm.size() > 1) {
+      IndexDataHandle dh(*this,indexSet,rank);
+      hostGridView.communicate(dh,All_All_Interface,ForwardCommunication);
+    }
+
+    // the ownership information is not needed any longer
+    for (auto& c : _codims)
+      c.owners.clear();
+    _valid = true;
+  }
+
+private:
+
+  typedef typename IndexSet::Grid Grid;
+  typedef typename Grid::HostGrid HostGrid;
+  typedef std::array<GlobalIndexType,dimension+1> Sizes;
+
+  static constexpr std::size_t noSlot = std::numeric_limits<std::size_t>::max();
+  static constexpr GlobalIndexType invalid = std::numeric_limits<GlobalIndexType>::max();
+
+  template<int codim>
+  static constexpr bool enabled()
+  {
+    return Grid::MDGridTraits::template Codim<codim>::supported &&
+      Capabilities::hasEntity<HostGrid,codim>::v &&
+      Capabilities::canCommunicate<HostGrid,codim>::v;
+  }
+
+  struct CodimData
+  {
+    bool enabled = false;
+    std::size_t types = 0;
+    //! Start of every geometry type of every subdomain in values.
+    std::vector<std::size_t> offsets;
+    std::vector<GlobalIndexType> values;
+    //! The owner rank of every entity, -1 for overlap and ghost entities; only used during update().
+    std::vector<std::vector<int> > owners;
+  };
+
+  std::size_t slot(SubDomainIndex subDomain) const
+  {
+    return subDomain < _slots.size() ? _slots[subDomain] : noSlot;
+  }
+
+  template<int codim, typename MapEntry>
+  static IndexType localIndex(const IndexSet& indexSet, const MapEntry& me, SubDomainIndex subDomain)
+  {
+    if (me.domains.simple())
+      return me.index;
+    return indexSet.template multiIndexMap<codim>()[me.index][me.domains.domainOffset(subDomain)];
+  }
+
+  //! Determines the lowest candidate rank for every border entity.
+  struct OwnerDataHandle
+    : public CommDataHandleIF<OwnerDataHandle,int>
+  {
+
+    bool contains(int dim, int codim) const
+    {
+      return codim > 0 && _indices._codims[codim].enabled;
+    }
+
+    bool fixedSize(int dim, int codim) const
+    {
+      return true;
+    }
+
+    template<typename Entity>
+    std::size_t size(const Entity& e) const
+    {
+      return 1;
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void gather(MessageBuffer& buf, const Entity& e) const
+    {
+      if constexpr (enabled<Entity::codimension>())
+        buf.write(ownerOf(e));
+      else
+        buf.write(-1);
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void scatter(MessageBuffer& buf, const Entity& e, std::size_t n)
+    {
+      int remote;
+      buf.read(remote);
+      if constexpr (enabled<Entity::codimension>()) {
+        int& local = ownerOf(e);
+        if (local >= 0 && remote >= 0)
+          local = std::min(local,remote);
+      }
+    }
+
+    template<typename Entity>
+    int& ownerOf(const Entity& e) const
+    {
+      return _indices._codims[Entity::codimension].owners[LocalGeometryTypeIndex::index(e.type())][_indexSet._hostGridView.indexSet().index(e)];
+    }
+
+    OwnerDataHandle(GlobalSubDomainIndices& indices, const IndexSet& indexSet)
+      : _indices(indices)
+      , _indexSet(indexSet)
+    {}
+
+    GlobalSubDomainIndices& _indices;
+    const IndexSet& _indexSet;
+
+  };
+
+  //! Sends pairs of subdomain and global index from the owner of an entity to all of its copies.
+  struct IndexDataHandle
+    : public CommDataHandleIF<IndexDataHandle,GlobalIndexType>
+  {
+
+    bool contains(int dim, int codim) const
+    {
+      return _indices._codims[codim].enabled;
+    }
+
+    bool fixedSize(int dim, int codim) const
+    {
+      return false;
+    }
+
+    template<typename Entity>
+    std::size_t size(const Entity& e) const
+    {
+      if constexpr (enabled<Entity::codimension>())
+        return owned(e) ? 2 * entry(e).domains.size() : 0;
+      else
+        return 0;
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void gather(MessageBuffer& buf, const Entity& e) const
+    {
+      if constexpr (enabled<Entity::codimension>()) {
+        if (!owned(e))
+          return;
+        const auto& me = entry(e);
+        for (const auto& subDomain : me.domains) {
+          buf.write(GlobalIndexType(subDomain));
+          buf.write(value(e,me,subDomain));
+        }
+      }
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void scatter(MessageBuffer& buf, const Entity& e, std::size_t n)
+    {
+      for (std::size_t k = 0; k < n; k += 2) {
+        GlobalIndexType subDomain, index;
+        buf.read(subDomain);
+        buf.read(index);
+        if constexpr (enabled<Entity::codimension>()) {
+          const auto& me = entry(e);
+          if (!owned(e) && me.domains.contains(subDomain))
+            value(e,me,subDomain) = index;
+        }
+      }
+    }
+
+    template<typename Entity>
+    bool owned(const Entity& e) const
+    {
+      return _indices._codims[Entity::codimension].owners[LocalGeometryTypeIndex::index(e.type())][_indexSet._hostGridView.indexSet().index(e)] == _rank;
+    }
+
+    template<typename Entity>
+    const auto& entry(const Entity& e) const
+    {
+      return _indexSet.template indexMap<Entity::codimension>()[LocalGeometryTypeIndex::index(e.type())][_indexSet._hostGridView.indexSet().index(e)];
+    }
+
+    template<typename Entity, typename MapEntry>
+    GlobalIndexType& value(const Entity& e, const MapEntry& me, SubDomainIndex subDomain) const
+    {
+      CodimData& c = _indices._codims[Entity::codimension];
+      const std::size_t t = LocalGeometryTypeIndex::index(e.type());
+      return c.values[c.offsets[_indices.slot(subDomain) * c.types + t] + localIndex<Entity::codimension>(_indexSet,me,subDomain)];
+    }
+
+    IndexDataHandle(GlobalSubDomainIndices& indices, const IndexSet& indexSet, int rank)
+      : _indices(indices)
+      , _indexSet(indexSet)
+      , _rank(rank)
+    {}
+
+    GlobalSubDomainIndices& _indices;
+    const IndexSet& _indexSet;
+    const int _rank;
+
+  };
+
+  bool _valid = false;
+  std::array<CodimData,dimension+1> _codims;
+  std::vector<std::size_t> _slots;
+  std::vector<std::pair<SubDomainIndex,Sizes> > _sizes;
+
+};
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_GLOBALSUBDOMAININDICES_HH
@@ -13,11 +13,13 @@
 
 #include <dune/common/hybridutilities.hh>
 
+#include <dune/geometry/referenceelements.hh>
 #include <dune/geometry/typeindex.hh>
 
 #include <dune/grid/common/exceptions.hh>
 #include <dune/grid/common/indexidset.hh>
 
+#include <dune/grid/multidomaingrid/globalsubdomainindices.hh>
 #include <dune/grid/multidomaingrid/utility.hh>
 #include <dune/grid/multidomaingrid/subdomaingrid/indexsets.hh>
 
@@ -255,6 +257,12 @@ class IndexSetWrapper :
   template<typename>
   friend class AllInterfacesController;
 
+  template<typename>
+  friend class MonolithicMCMGMapper;
+
+  template<typename>
+  friend class GlobalSubDomainIndices;
+
   typedef IndexSetWrapper<GridImp,HostGridViewType> ThisType;
 
   using HostGrid = typename Grid::HostGrid;
@@ -283,9 +291,21 @@ public:
 
 
   typedef typename HostIndexSet::IndexType IndexType;
+  //! The type of the process-wide consistent subdomain indices, see globalIndex().
+  typedef std::size_t GlobalIndexType;
   static const int dimension = Grid::dimension;
   static const std::size_t maxSubDomains = SubDomainSet::maxSize;
 
+  //! An edge of the subdomain adjacency graph, see subDomainGraph().
+  struct SubDomainGraphEdge {
+    //! The smaller of the two subdomain indices.
+    SubDomainIndex subDomain1;
+    //! The larger of the two subdomain indices.
+    SubDomainIndex subDomain2;
+    //! The number of entities contained in both subdomains, indexed by codimension.
+    std::array<IndexType,dimension+1> sharedEntities;
+  };
+
 private:
 
   typedef typename HostGridView::template Codim<0>::Iterator HostEntityIterator;
@@ -527,7 +547,7 @@ private:
   template<typename HostEntity>
   IndexType subIndexForSubDomain(SubDomainIndex subDomain, const HostEntity& he, int i, int codim) const {
     return getSubIndexForSubDomain(subDomain,
-                                   referenceElement(he.geometry()).type(i,codim - he.codimension),
+                                   ReferenceElements<typename HostGrid::ctype,HostEntity::mydimension>::general(he.type()).type(i,codim - he.codimension),
                                    _hostGridView.indexSet().subIndex(he,i,codim),
                                    *this).dispatch(codim);
   }
@@ -605,6 +625,12 @@ public:
     return subIndexForSubDomain(subDomain,_grid.hostEntity(e),i,codim);
   }
 
+  //! Returns the subdomain index of subentity i of e, whose geometry type gt is already known to the caller.
+  template<typename SubDomainEntity>
+  IndexType subIndex(SubDomainIndex subDomain, const SubDomainEntity& e, int i, int codim, GeometryType gt) const {
+    return getSubIndexForSubDomain(subDomain,gt,_hostGridView.indexSet().subIndex(_grid.hostEntity(e),i,codim),*this).dispatch(codim);
+  }
+
   Types types(SubDomainIndex subDomain, int codim) const {
     return types(codim);
   }
@@ -617,6 +643,66 @@ public:
     return sizeForSubDomain(subDomain,codim);
   }
 
+  //! Returns the subdomain adjacency graph.
+  /**
+   * The graph contains an edge for every pair of subdomains that share at least one entity,
+   * sorted by the subdomain indices. Every edge stores the number of shared entities for each
+   * codimension, which for non-overlapping subdomains are the faces, edges and vertices of their
+   * interface. Entities of codimensions that are not supported by the MDGridTraits are not counted.
+   *
+   * The graph is built as a byproduct of the index update of the leaf index set and only
+   * contains the entities of the local process (including ghosts and overlap).
+   */
+  const std::vector<SubDomainGraphEdge>& subDomainGraph() const {
+    return _subDomainGraph;
+  }
+
+  //! Returns the number of entities of codimension codim shared by two different subdomains.
+  IndexType sharedEntities(SubDomainIndex subDomain1, SubDomainIndex subDomain2, int codim) const {
+    assert(subDomain1 != subDomain2);
+    if (subDomain2 < subDomain1)
+      std::swap(subDomain1,subDomain2);
+    auto it = std::lower_bound(_subDomainGraph.begin(),_subDomainGraph.end(),std::make_pair(subDomain1,subDomain2),
+                               [](const SubDomainGraphEdge& edge, const std::pair<SubDomainIndex,SubDomainIndex>& key) {
+                                 return std::make_pair(edge.subDomain1,edge.subDomain2) < key;
+                               });
+    if (it == _subDomainGraph.end() || it->subDomain1 != subDomain1 || it->subDomain2 != subDomain2)
+      return 0;
+    return it->sharedEntities[codim];
+  }
+
+  //! Returns the indices of all subdomains that contain at least one entity, in ascending order.
+  const std::vector<SubDomainIndex>& activeSubDomains() const {
+    return _activeSubDomains;
+  }
+
+  //! Returns whether process-wide consistent subdomain indices are available for codimension codim.
+  /**
+   * Global indices are only computed for the leaf index set and only if enabled by
+   * MultiDomainGrid::setGlobalSubDomainIndexing().
+   */
+  bool hasGlobalIndices(int codim) const {
+    return _globalIndices && _globalIndices->contains(codim);
+  }
+
+  //! Returns the index of e in subDomain that is consistent across all processes.
+  /**
+   * The global indices of each subdomain and codimension are consecutive, starting at 0, across
+   * all processes, and every copy of an entity has the same global index on every process.
+   * Requires hasGlobalIndices() for the codimension of e.
+   */
+  template<typename EntityType>
+  GlobalIndexType globalIndex(SubDomainIndex subDomain, const EntityType& e) const {
+    assert(hasGlobalIndices(EntityType::codimension));
+    return _globalIndices->index(subDomain,EntityType::codimension,LocalGeometryTypeIndex::index(e.type()),index(subDomain,e));
+  }
+
+  //! Returns the number of entities of codimension codim in subDomain across all processes.
+  GlobalIndexType globalSize(SubDomainIndex subDomain, int codim) const {
+    assert(hasGlobalIndices(codim));
+    return _globalIndices->size(subDomain,codim);
+  }
+
   //! Returns true if the entity is contained in a specific subdomain.
   template<typename EntityType>
   bool contains(SubDomainIndex subDomain, const EntityType& e) const {
@@ -631,10 +717,16 @@ private:
   const GridImp& _grid;
   HostGridView _hostGridView;
   ContainerMap _containers;
+  std::vector<SubDomainGraphEdge> _subDomainGraph;
+  std::vector<SubDomainIndex> _activeSubDomains;
+  std::shared_ptr<const GlobalSubDomainIndices<ThisType> > _globalIndices;
 
   void swap(ThisType& rhs) {
     assert(&_grid == &rhs._grid);
     std::swap(_containers,rhs._containers);
+    std::swap(_subDomainGraph,rhs._subDomainGraph);
+    std::swap(_activeSubDomains,rhs._activeSubDomains);
+    std::swap(_globalIndices,rhs._globalIndices);
   }
 
   void addToSubDomain(SubDomainIndex subDomain, const Codim0Entity& e) {
@@ -681,7 +773,10 @@ private:
   explicit IndexSetWrapper(const ThisType& rhs) :
     _grid(rhs._grid),
     _hostGridView(rhs._hostGridView),
-    _containers(rhs._containers)
+    _containers(rhs._containers),
+    _subDomainGraph(rhs._subDomainGraph),
+    _activeSubDomains(rhs._activeSubDomains),
+    _globalIndices(rhs._globalIndices)
     {}
 
 
@@ -824,60 +919,75 @@ private:
       levelIndexSet->reset(full);
     }
 
-    this->communicateSubDomainSelection();
-
+    // Cells that are not interior receive their subdomains from their owners, so they are only
+    // processed after the exchange of the subdomain sets.
+    std::vector<HostEntity> copies;
     auto& im = indexMap<0>();
-    auto& sm = sizeMap<0>();
     for (const auto& he : elements(_hostGridView)) {
-      // get map entry for host entity
-      auto geo = he.geometry();
-      auto hgt = geo.type();
-      const auto hgt_index = LocalGeometryTypeIndex::index(hgt);
-      IndexType hostIndex = his.index(he);
-      MapEntry<0>& me = im[hgt_index][hostIndex];
-
-      if (_grid.supportLevelIndexSets()) {
-        // include subdomain in entity lvl
-        IndexType hostLvlIndex = levelIndexSets[he.level()]->_hostGridView.indexSet().index(he);
-        levelIndexSets[he.level()]->template indexMap<0>()[hgt_index][hostLvlIndex].domains.addAll(me.domains);
-        // propagate subdomain to all ancestors
-        markAncestors(levelIndexSets,he,me.domains);
+      if (he.partitionType() != InteriorEntity) {
+        copies.push_back(he);
+        continue;
       }
-      updateMapEntry(me,sm[hgt_index],multiIndexMap<0>());
-      applyToCodims(markSubIndices(he,me.domains,his,geo));
+      markLeafCell(levelIndexSets,he,his,im);
     }
 
-    propagateBorderEntitySubDomains();
+    communicateSubDomainSets();
+
+    for (const auto& he : copies)
+      markLeafCell(levelIndexSets,he,his,im);
 
     applyToCodims(updateSubIndices(*this));
     applyToCodims(updatePerCodimSizes());
+    updateActiveSubDomains();
+    updateSubDomainGraph();
+    updateGlobalIndices();
     for(auto& levelIndexSet : levelIndexSets) {
       levelIndexSet->updateLevelIndexSet();
     }
   }
 
 
+  //! Marks the subentities of a leaf cell and propagates its subdomains to the level index sets.
+  void markLeafCell(LevelIndexSets& levelIndexSets, const HostEntity& he, const HostIndexSet& his, typename Containers<0>::IndexMap& im) {
+    auto geo = he.geometry();
+    const auto hgt_index = LocalGeometryTypeIndex::index(geo.type());
+    MapEntry<0>& me = im[hgt_index][his.index(he)];
+
+    if (_grid.supportLevelIndexSets()) {
+      // include subdomain in entity lvl
+      IndexType hostLvlIndex = levelIndexSets[he.level()]->_hostGridView.indexSet().index(he);
+      levelIndexSets[he.level()]->template indexMap<0>()[hgt_index][hostLvlIndex].domains.addAll(me.domains);
+      // propagate subdomain to all ancestors
+      markAncestors(levelIndexSets,he,me.domains);
+    }
+    applyToCodims(markSubIndices(he,me.domains,his,geo));
+  }
+
   void updateLevelIndexSet() {
     const HostIndexSet& his = _hostGridView.indexSet();
     typename Containers<0>::IndexMap& im = indexMap<0>();
-    typename Containers<0>::SizeMap& sm = sizeMap<0>();
-
-    communicateSubDomainSelection();
 
+    // see update() for the treatment of cells that are not interior
+    std::vector<HostEntity> copies;
     for (const auto& he : elements(_hostGridView)) {
-      auto geo = he.geometry();
-      const GeometryType hgt = geo.type();
-      const auto hgt_index = LocalGeometryTypeIndex::index(hgt);
-      IndexType hostIndex = his.index(he);
-      MapEntry<0>& me = im[hgt_index][hostIndex];
-      updateMapEntry(me,sm[hgt_index],multiIndexMap<0>());
-      applyToCodims(markSubIndices(he,me.domains,his,geo));
+      if (he.partitionType() != InteriorEntity) {
+        copies.push_back(he);
+        continue;
+      }
+      MapEntry<0>& me = im[LocalGeometryTypeIndex::index(he.type())][his.index(he)];
+      applyToCodims(markSubIndices(he,me.domains,his,he.geometry()));
     }
 
-    propagateBorderEntitySubDomains();
+    communicateSubDomainSets();
+
+    for (const auto& he : copies) {
+      MapEntry<0>& me = im[LocalGeometryTypeIndex::index(he.type())][his.index(he)];
+      applyToCodims(markSubIndices(he,me.domains,his,he.geometry()));
+    }
 
     applyToCodims(updateSubIndices(*this));
     applyToCodims(updatePerCodimSizes());
+    updateActiveSubDomains();
   }
 
   template<int codim, typename SizeContainer, typename MultiIndexContainer>
@@ -943,8 +1053,6 @@ private:
 
     template<int codim>
     void apply(Containers<codim>& c) const {
-      if (codim == 0)
-        return;
       for (std::size_t gt_index = 0,
              gt_end = c.indexMap.size();
            gt_index != gt_end;
@@ -960,6 +1068,83 @@ private:
     {}
   };
 
+  typedef std::map<std::pair<SubDomainIndex,SubDomainIndex>,std::array<IndexType,dimension+1> > SharedEntityCounts;
+
+  struct countSharedEntities : public applyToCodim<const countSharedEntities> {
+
+    template<int codim>
+    void apply(Containers<codim>& c) const {
+      for (const auto& entries : c.indexMap)
+        for (const auto& me : entries) {
+          if (me.domains.state() != MapEntry<codim>::SubDomainSet::multipleSet)
+            continue;
+          for (auto it1 = me.domains.begin(), end = me.domains.end(); it1 != end; ++it1) {
+            auto it2 = it1;
+            for (++it2; it2 != end; ++it2) {
+              const SubDomainIndex a = *it1;
+              const SubDomainIndex b = *it2;
+              ++_counts[std::make_pair(std::min(a,b),std::max(a,b))][codim];
+            }
+          }
+        }
+    }
+
+    SharedEntityCounts& _counts;
+
+    countSharedEntities(SharedEntityCounts& counts) :
+      _counts(counts)
+    {}
+  };
+
+  struct collectActiveSubDomains : public applyToCodim<const collectActiveSubDomains> {
+
+    template<int codim>
+    void apply(Containers<codim>& c) const {
+      if (_active.size() < c.codimSizeMap.size())
+        _active.resize(c.codimSizeMap.size(),false);
+      for (std::size_t subDomain = 0; subDomain < c.codimSizeMap.size(); ++subDomain)
+        if (c.codimSizeMap[subDomain] > 0)
+          _active[subDomain] = true;
+    }
+
+    std::vector<bool>& _active;
+
+    collectActiveSubDomains(std::vector<bool>& active) :
+      _active(active)
+    {}
+
+  };
+
+  //! Recomputes the global subdomain indices, which requires communication if enabled.
+  void updateGlobalIndices() {
+    if (!_grid.globalSubDomainIndexing()) {
+      _globalIndices.reset();
+      return;
+    }
+    auto globalIndices = std::make_shared<GlobalSubDomainIndices<ThisType> >();
+    globalIndices->update(*this);
+    _globalIndices = globalIndices;
+  }
+
+  void updateActiveSubDomains() {
+    // subentities on processor borders can belong to subdomains without local cells
+    std::vector<bool> active;
+    applyToCodims(collectActiveSubDomains(active));
+    _activeSubDomains.clear();
+    for (std::size_t subDomain = 0; subDomain < active.size(); ++subDomain)
+      if (active[subDomain])
+        _activeSubDomains.push_back(subDomain);
+  }
+
+  void updateSubDomainGraph() {
+    SharedEntityCounts counts;
+    applyToCodims(countSharedEntities(counts));
+    _subDomainGraph.clear();
+    _subDomainGraph.reserve(counts.size());
+    for (const auto& count : counts)
+      _subDomainGraph.push_back({count.first.first,count.first.second,count.second});
+  }
+
   //! functor template for retrieving a subindex.
   struct getSupportsCodim : public dispatchToCodim<getSupportsCodim,bool,false> {
 
@@ -975,15 +1160,26 @@ private:
     return getSupportsCodim().dispatch(codim);
   }
 
-  template<typename Impl>
-  struct SubDomainSetDataHandleBase
-    : public Dune::CommDataHandleIF<Impl,
+  //! Exchanges the subdomain sets of all supported codimensions in a single communication.
+  /**
+   * Cells are only sent by their owners, so overlap and ghost cells receive the subdomains of
+   * their interior copy. The sets of lower-dimensional entities are merged across all processes
+   * that have the entity as an interior or border entity, which only requires the contributions
+   * of the interior cells.
+   */
+  struct SubDomainSetDataHandle
+    : public Dune::CommDataHandleIF<SubDomainSetDataHandle,
                                     typename MapEntry<0>::SubDomainSet::DataHandle::DataType
                                     >
   {
     typedef typename MapEntry<0>::SubDomainSet SubDomainSet;
     typedef typename SubDomainSet::DataHandle DataHandle;
 
+    bool contains(int dim, int codim) const
+    {
+      return _indexSet.supportsCodim(codim);
+    }
+
     bool fixedSize(int dim, int codim) const
     {
       return DataHandle::fixedSize(dim,codim);
@@ -1007,7 +1203,7 @@ private:
       MapEntry<Entity::codimension>::SubDomainSet::DataHandle::scatter(buf,_indexSet.subDomainsForHostEntity(e),n);
     }
 
-    SubDomainSetDataHandleBase(ThisType& indexSet)
+    SubDomainSetDataHandle(ThisType& indexSet)
       : _indexSet(indexSet)
     {}
 
@@ -1015,46 +1211,9 @@ private:
 
   };
 
-  struct SelectionDataHandle
-    : public SubDomainSetDataHandleBase<SelectionDataHandle>
-  {
-
-    bool contains(int dim, int codim) const
-    {
-      return codim == 0;
-    }
-
-    SelectionDataHandle(ThisType& indexSet)
-      : SubDomainSetDataHandleBase<SelectionDataHandle>(indexSet)
-    {}
-
-  };
-
-  struct BorderPropagationDataHandle
-    : public SubDomainSetDataHandleBase<BorderPropagationDataHandle>
-  {
-
-    bool contains(int dim, int codim) const
-    {
-      return codim > 0 && this->_indexSet.supportsCodim(codim);
-    }
-
-    BorderPropagationDataHandle(ThisType& indexSet)
-      : SubDomainSetDataHandleBase<BorderPropagationDataHandle>(indexSet)
-    {}
-
-  };
-
-
-  void communicateSubDomainSelection()
-  {
-    SelectionDataHandle dh(*this);
-    _hostGridView.template communicate<SelectionDataHandle>(dh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
-  }
-
-  void propagateBorderEntitySubDomains()
+  void communicateSubDomainSets()
   {
-    BorderPropagationDataHandle dh(*this);
+    SubDomainSetDataHandle dh(*this);
     _hostGridView.communicate(dh,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
   }
 
@@ -0,0 +1,359 @@
+#ifndef DUNE_MULTIDOMAINGRID_INTERFACEMCMGMAPPER_HH
+#define DUNE_MULTIDOMAINGRID_INTERFACEMCMGMAPPER_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/common/capabilities.hh>
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+/**
+ * @addtogroup Mapper
+ *
+ * @{
+ */
+
+//! Consecutive numbering of the entities shared by two subdomains.
+/**
+ * InterfaceMCMGMapper numbers all entities of a grid view of a MultiDomainGrid that are
+ * contained in both subDomain1 and subDomain2 and whose geometry type is selected by an
+ * MCMGLayout, e.g. the faces, edges and vertices on the interface between two subdomains.
+ * This is the index space required for Lagrange multipliers and mortar spaces.
+ *
+ * The mapper is built from the subdomain sets stored by the MultiDomainGrid index set, so it
+ * does not need to traverse the interface. Entities are numbered by geometry type in the order
+ * of GlobalGeometryTypeIndex, and within each geometry type by their index in the grid view.
+ * The numbering thus does not depend on the traversal order. index() is a single table lookup.
+ *
+ * Only codimensions supported by the MDGridTraits of the grid are numbered.
+ *
+ * On a distributed grid, index() is local to each process. In addition, globalIndex() numbers
+ * the shared entities consecutively across all processes, following the ownership rule of
+ * GlobalSubDomainIndices: interior entities are owned by the local process, border entities by
+ * the lowest rank that has them as interior or border entities. Each process numbers its owned
+ * entities in the order of index(), starting at the number of entities owned by all lower ranks,
+ * and sends their indices to all copies. Global indices are only consistent for codimensions
+ * that the host grid can communicate.
+ *
+ * \note The construction and update() are collective operations. The mapper becomes invalid
+ *       when the grid or the subdomain layout is modified and has to be updated with update().
+ *
+ * \tparam GV  a leaf or level grid view of a MultiDomainGrid.
+ */
+template<typename GV>
+class InterfaceMCMGMapper
+{
+
+  typedef typename GV::Grid Grid;
+
+public:
+
+  typedef GV GridView;
+  typedef typename GV::IndexSet::IndexType IndexType;
+  typedef std::size_t GlobalIndexType;
+  typedef typename Grid::SubDomainIndex SubDomainIndex;
+  typedef typename GV::template Codim<0>::Entity Element;
+
+  static const int dimension = GV::dimension;
+
+  InterfaceMCMGMapper(const GV& gv, SubDomainIndex subDomain1, SubDomainIndex subDomain2, const MCMGLayout& layout)
+    : _gridView(gv)
+    , _subDomain1(subDomain1)
+    , _subDomain2(subDomain2)
+    , _layout(layout)
+  {
+    update(gv);
+  }
+
+  const GridView& gridView() const
+  {
+    return _gridView;
+  }
+
+  const MCMGLayout& layout() const
+  {
+    return _layout;
+  }
+
+  SubDomainIndex subDomain1() const
+  {
+    return _subDomain1;
+  }
+
+  SubDomainIndex subDomain2() const
+  {
+    return _subDomain2;
+  }
+
+  //! Returns the index of an entity, which must be shared by both subdomains.
+  template<class EntityType>
+  IndexType index(const EntityType& e) const
+  {
+    const IndexType result = lookup(e.type(),_gridView.indexSet().index(e));
+    assert(result != invalid);
+    return result;
+  }
+
+  //! Returns the index of subentity i of codimension codim of e, which must be shared by both subdomains.
+  IndexType subIndex(const Element& e, int i, unsigned int codim) const
+  {
+    const GeometryType gt = ReferenceElements<typename GV::ctype,dimension>::general(e.type()).type(i,codim);
+    const IndexType result = lookup(gt,_gridView.indexSet().subIndex(e,i,codim));
+    assert(result != invalid);
+    return result;
+  }
+
+  //! Returns true and stores the index in result if the entity is numbered by the mapper.
+  template<class EntityType>
+  bool contains(const EntityType& e, IndexType& result) const
+  {
+    result = lookup(e.type(),_gridView.indexSet().index(e));
+    return checkResult(result);
+  }
+
+  //! Returns true and stores the index in result if subentity i of codimension codim of e is numbered by the mapper.
+  bool contains(const Element& e, int i, int codim, IndexType& result) const
+  {
+    const GeometryType gt = ReferenceElements<typename GV::ctype,dimension>::general(e.type()).type(i,codim);
+    result = lookup(gt,_gridView.indexSet().subIndex(e,i,codim));
+    return checkResult(result);
+  }
+
+  //! Returns the index of an entity in the numbering that is consistent across all processes.
+  template<class EntityType>
+  GlobalIndexType globalIndex(const EntityType& e) const
+  {
+    const GlobalIndexType result = _globalIndices[index(e)];
+    assert(result != invalidGlobal);
+    return result;
+  }
+
+  //! Returns the global index of subentity i of codimension codim of e.
+  GlobalIndexType globalSubIndex(const Element& e, int i, unsigned int codim) const
+  {
+    const GlobalIndexType result = _globalIndices[subIndex(e,i,codim)];
+    assert(result != invalidGlobal);
+    return result;
+  }
+
+  //! Returns the number of entities shared by both subdomains across all processes.
+  GlobalIndexType globalSize() const
+  {
+    return _globalSize;
+  }
+
+  //! Returns the number of entities shared by both subdomains.
+  std::size_t size() const
+  {
+    return _offsets.back();
+  }
+
+  //! Returns the number of shared entities with the given geometry type.
+  std::size_t size(GeometryType gt) const
+  {
+    const std::size_t t = GlobalGeometryTypeIndex::index(gt);
+    return _offsets[t+1] - _offsets[t];
+  }
+
+  //! Returns the index of the first entity with the given geometry type.
+  std::size_t offset(GeometryType gt) const
+  {
+    return _offsets[GlobalGeometryTypeIndex::index(gt)];
+  }
+
+  //! Recalculates the numbering for the grid view gv.
+  void update(const GV& gv)
+  {
+    _gridView = gv;
+    const auto& indexSet = _gridView.indexSet();
+    const std::size_t types = GlobalGeometryTypeIndex::size(dimension);
+    _indices.assign(types,std::vector<IndexType>());
+    _offsets.assign(types + 1,0);
+    for (int codim = 0; codim <= dimension; ++codim)
+      for (auto gt : indexSet.types(codim))
+        if (_layout(gt,dimension))
+          _indices[GlobalGeometryTypeIndex::index(gt)].assign(indexSet.size(gt),invalid);
+
+    // mark the shared entities with 1 if they are candidates for ownership and 0 otherwise; a
+    // shared entity need not be a subentity of a local cell of subDomain1 on a distributed grid
+    for (const auto& cell : elements(_gridView)) {
+      const auto& refElement = ReferenceElements<typename GV::ctype,dimension>::general(cell.type());
+      Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+          if constexpr (Capabilities::hasEntity<Grid,codim>::v && Grid::MDGridTraits::template Codim<codim>::supported) {
+            const unsigned int count = cell.subEntities(codim);
+            for (unsigned int i = 0; i < count; ++i) {
+              auto& indices = _indices[GlobalGeometryTypeIndex::index(refElement.type(i,codim))];
+              if (indices.empty())
+                continue;
+              const auto subEntity = cell.template subEntity<codim>(i);
+              const auto& subDomains = indexSet.subDomains(subEntity);
+              if (subDomains.contains(_subDomain1) && subDomains.contains(_subDomain2)) {
+                const PartitionType pt = subEntity.partitionType();
+                indices[indexSet.index(subEntity)] = pt == InteriorEntity || pt == BorderEntity;
+              }
+            }
+          }
+        });
+    }
+
+    // number the marked entities in ascending index order
+    const int rank = _gridView.comm().rank();
+    std::vector<int> owners;
+    IndexType next = 0;
+    for (std::size_t t = 0; t < types; ++t) {
+      for (auto& index : _indices[t])
+        if (index != invalid) {
+          owners.push_back(index ? rank : -1);
+          index = next++;
+        }
+      _offsets[t+1] = next;
+    }
+
+    updateGlobalIndices(owners);
+  }
+
+private:
+
+  static constexpr IndexType invalid = std::numeric_limits<IndexType>::max();
+  static constexpr GlobalIndexType invalidGlobal = std::numeric_limits<GlobalIndexType>::max();
+
+  //! Exchanges a value per shared entity, either keeping the minimum of all candidates or filling in missing values.
+  template<typename T, bool minimum>
+  struct ExchangeDataHandle
+    : public CommDataHandleIF<ExchangeDataHandle<T,minimum>,T>
+  {
+
+    bool contains(int dim, int codim) const
+    {
+      return _mapper._communicate[codim];
+    }
+
+    bool fixedSize(int dim, int codim) const
+    {
+      return true;
+    }
+
+    template<typename Entity>
+    std::size_t size(const Entity& e) const
+    {
+      return 1;
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void gather(MessageBuffer& buf, const Entity& e) const
+    {
+      IndexType i;
+      buf.write(_mapper.contains(e,i) ? _values[i] : _none);
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void scatter(MessageBuffer& buf, const Entity& e, std::size_t n)
+    {
+      T remote;
+      buf.read(remote);
+      IndexType i;
+      if (remote == _none || !_mapper.contains(e,i) || (minimum && _values[i] == _none))
+        return;
+      if (minimum)
+        _values[i] = std::min(_values[i],remote);
+      else if (_values[i] == _none)
+        _values[i] = remote;
+    }
+
+    ExchangeDataHandle(const InterfaceMCMGMapper& mapper, std::vector<T>& values, T none)
+      : _mapper(mapper)
+      , _values(values)
+      , _none(none)
+    {}
+
+    const InterfaceMCMGMapper& _mapper;
+    std::vector<T>& _values;
+    const T _none;
+
+  };
+
+  //! Computes the numbering across all processes from the owner candidates of the shared entities.
+  void updateGlobalIndices(std::vector<int>& owners)
+  {
+    const auto& comm = _gridView.comm();
+    const int rank = comm.rank();
+
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        _communicate[codim] = Capabilities::canCommunicate<typename Grid::HostGrid,codim>::v;
+      });
+
+    // determine the owners of border entities
+    if (comm.size() > 1) {
+      ExchangeDataHandle<int,true> dh(*this,owners,-1);
+      _gridView.communicate(dh,InteriorBorder_InteriorBorder_Interface,ForwardCommunication);
+    }
+
+    // the owned entities of lower ranks come first
+    GlobalIndexType owned = std::count(owners.begin(),owners.end(),rank);
+    std::vector<GlobalIndexType> counts(comm.size());
+    comm.allgather(&owned,1,counts.data());
+    GlobalIndexType next = std::accumulate(counts.begin(),counts.begin() + rank,GlobalIndexType(0));
+    _globalSize = std::accumulate(counts.begin(),counts.end(),GlobalIndexType(0));
+    _globalIndices.assign(owners.size(),invalidGlobal);
+    for (std::size_t i = 0; i < owners.size(); ++i)
+      if (owners[i] == rank)
+        _globalIndices[i] = next++;
+
+    // send the indices of owned entities to all copies
+    if (comm.size() > 1) {
+      ExchangeDataHandle<GlobalIndexType,false> dh(*this,_globalIndices,invalidGlobal);
+      _gridView.communicate(dh,All_All_Interface,ForwardCommunication);
+    }
+  }
+
+  IndexType lookup(GeometryType gt, IndexType index) const
+  {
+    const auto& indices = _indices[GlobalGeometryTypeIndex::index(gt)];
+    return indices.empty() ? invalid : indices[index];
+  }
+
+  static bool checkResult(IndexType& result)
+  {
+    if (result == invalid) {
+      result = 0;
+      return false;
+    }
+    return true;
+  }
+
+  GridView _gridView;
+  SubDomainIndex _subDomain1;
+  SubDomainIndex _subDomain2;
+  MCMGLayout _layout;
+  std::vector<std::vector<IndexType> > _indices;
+  std::vector<std::size_t> _offsets;
+  std::vector<GlobalIndexType> _globalIndices;
+  GlobalIndexType _globalSize = 0;
+  std::array<bool,dimension+1> _communicate = {};
+
+};
+
+/** @} */
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_INTERFACEMCMGMAPPER_HH
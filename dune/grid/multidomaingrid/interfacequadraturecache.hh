@@ -0,0 +1,175 @@
+#ifndef DUNE_MULTIDOMAINGRID_INTERFACEQUADRATURECACHE_HH
+#define DUNE_MULTIDOMAINGRID_INTERFACEQUADRATURECACHE_HH
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/grid/multidomaingrid/subdomaininterfacerange.hh>
+#include <dune/grid/multidomaingrid/utility.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+//! Precomputed quadrature data for the faces of a subdomain interface.
+/**
+ * The cache evaluates a quadrature rule of the requested order on every face of a
+ * SubDomainInterfaceRange once and stores the results in separate flat arrays (structure of
+ * arrays). For every quadrature point, it stores
+ *
+ * - the global position,
+ * - the quadrature weight multiplied by the integration element,
+ * - the local positions in the inside and outside cells (NaN in the outside cell for remote
+ *   faces, see SubDomainInterfaceRange::Face::remote()) and
+ * - the unit outer normal of the inside cell.
+ *
+ * The points of face f occupy the positions [pointBegin(f),pointEnd(f)) of the arrays, so
+ * coupling kernels can stream through them without accessing the grid.
+ *
+ * \note The cache does not reference the grid and has to be rebuilt by the user after the grid
+ *       or the subdomain layout has been modified.
+ *
+ * \tparam GV  a leaf or level grid view of a MultiDomainGrid.
+ */
+template<typename GV>
+class InterfaceQuadratureCache
+{
+
+public:
+
+  typedef typename GV::ctype ctype;
+  static const int dimension = GV::dimension;
+  static const int dimensionworld = GV::dimensionworld;
+
+  typedef SubDomainInterfaceRange<GV> InterfaceRange;
+  typedef FieldVector<ctype,dimensionworld> GlobalCoordinate;
+  typedef FieldVector<ctype,dimension> CellCoordinate;
+
+  //! Evaluates a quadrature rule of the given order on all faces of range.
+  InterfaceQuadratureCache(const InterfaceRange& range, int order)
+    : _order(order)
+  {
+    _pointOffsets.reserve(range.size() + 1);
+    _pointOffsets.push_back(0);
+    for (const auto& face : range) {
+      const auto intersection = face.intersection();
+      const auto geometry = intersection.geometry();
+      const auto geometryInInside = intersection.geometryInInside();
+      std::optional<typename InterfaceRange::Intersection::LocalGeometry> geometryInOutside;
+      if (!face.remote())
+        geometryInOutside.emplace(intersection.geometryInOutside());
+      const auto& rule = QuadratureRules<ctype,dimension-1>::rule(intersection.type(),order);
+      for (const auto& qp : rule) {
+        const auto& local = qp.position();
+        _positions.push_back(geometry.global(local));
+        _weights.push_back(qp.weight() * geometry.integrationElement(local));
+        _insidePositions.push_back(geometryInInside.global(local));
+        _outsidePositions.push_back(geometryInOutside ? geometryInOutside->global(local) : CellCoordinate(std::numeric_limits<ctype>::quiet_NaN()));
+        _unitOuterNormals.push_back(intersection.unitOuterNormal(local));
+      }
+      _pointOffsets.push_back(_positions.size());
+    }
+  }
+
+  //! Returns the quadrature order the cache was built for.
+  int order() const {
+    return _order;
+  }
+
+  //! Returns the number of faces.
+  std::size_t faces() const {
+    return _pointOffsets.size() - 1;
+  }
+
+  //! Returns the total number of quadrature points.
+  std::size_t points() const {
+    return _positions.size();
+  }
+
+  //! Returns the position of the first quadrature point of face f.
+  std::size_t pointBegin(std::size_t f) const {
+    return _pointOffsets[f];
+  }
+
+  //! Returns the position after the last quadrature point of face f.
+  std::size_t pointEnd(std::size_t f) const {
+    return _pointOffsets[f+1];
+  }
+
+  //! Returns the global positions of the quadrature points of face f.
+  util::Span<const GlobalCoordinate> positions(std::size_t f) const {
+    return span(_positions,f);
+  }
+
+  //! Returns the quadrature weights of face f, multiplied by the integration element.
+  util::Span<const ctype> weights(std::size_t f) const {
+    return span(_weights,f);
+  }
+
+  //! Returns the quadrature points of face f in local coordinates of the inside cell.
+  util::Span<const CellCoordinate> insidePositions(std::size_t f) const {
+    return span(_insidePositions,f);
+  }
+
+  //! Returns the quadrature points of face f in local coordinates of the outside cell.
+  util::Span<const CellCoordinate> outsidePositions(std::size_t f) const {
+    return span(_outsidePositions,f);
+  }
+
+  //! Returns the unit outer normals of the inside cell at the quadrature points of face f.
+  util::Span<const GlobalCoordinate> unitOuterNormals(std::size_t f) const {
+    return span(_unitOuterNormals,f);
+  }
+
+  /** @name Flat arrays covering all faces */
+  /*@{*/
+
+  const std::vector<GlobalCoordinate>& positions() const {
+    return _positions;
+  }
+
+  const std::vector<ctype>& weights() const {
+    return _weights;
+  }
+
+  const std::vector<CellCoordinate>& insidePositions() const {
+    return _insidePositions;
+  }
+
+  const std::vector<CellCoordinate>& outsidePositions() const {
+    return _outsidePositions;
+  }
+
+  const std::vector<GlobalCoordinate>& unitOuterNormals() const {
+    return _unitOuterNormals;
+  }
+
+  /*@}*/
+
+private:
+
+  template<typename T>
+  util::Span<const T> span(const std::vector<T>& data, std::size_t f) const {
+    return util::Span<const T>(data.data() + _pointOffsets[f],data.data() + _pointOffsets[f+1]);
+  }
+
+  int _order;
+  std::vector<std::size_t> _pointOffsets;
+  std::vector<GlobalCoordinate> _positions;
+  std::vector<ctype> _weights;
+  std::vector<CellCoordinate> _insidePositions;
+  std::vector<CellCoordinate> _outsidePositions;
+  std::vector<GlobalCoordinate> _unitOuterNormals;
+
+};
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_INTERFACEQUADRATURECACHE_HH
@@ -0,0 +1,168 @@
+#ifndef DUNE_MULTIDOMAINGRID_LOADBALANCING_HH
+#define DUNE_MULTIDOMAINGRID_LOADBALANCING_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Dune {
+
+namespace mdgrid {
+
+//! Detects whether a host grid can be balanced to a given partition while migrating data.
+/**
+ * This is the case for grids like UGGrid that provide
+ * `loadBalance(const std::vector<int>& targetRanks, unsigned int fromLevel, DataHandle& dataHandle)`.
+ */
+template<typename HostGrid, typename DataHandle, typename = void>
+struct HasTargetPartitionLoadBalance
+  : public std::false_type
+{};
+
+template<typename HostGrid, typename DataHandle>
+struct HasTargetPartitionLoadBalance<HostGrid,DataHandle,
+                                     std::void_t<decltype(std::declval<HostGrid&>().loadBalance(std::declval<const std::vector<int>&>(),
+                                                                                                0u,
+                                                                                                std::declval<DataHandle&>()))>
+                                     >
+  : public std::true_type
+{};
+
+//! Returns the load balancing weight of a cell that belongs to the given subdomains.
+/**
+ * cost is either a callable that computes the weight from the SubDomainSet, or a container
+ * with the cost of a cell in every subdomain, indexed by subdomain. In the latter case, the
+ * weight of a cell in several subdomains is the sum of their costs, and subdomains beyond the
+ * end of the container do not contribute.
+ */
+template<typename Cost, typename SubDomainSet>
+double subDomainWeight(const Cost& cost, const SubDomainSet& subDomains)
+{
+  if constexpr (std::is_invocable_r_v<double,const Cost&,const SubDomainSet&>)
+    return cost(subDomains);
+  else {
+    double result = 0.0;
+    for (auto subDomain : subDomains)
+      if (std::size_t(subDomain) < cost.size())
+        result += cost[subDomain];
+    return result;
+  }
+}
+
+//! Partitions weighted points into parts of approximately equal weight by recursive coordinate bisection.
+/**
+ * Every process passes its local points, and the returned vector contains the part of every
+ * local point. All groups of parts of one bisection level are split simultaneously along the
+ * axis of their largest extent. The split coordinate is found by a bisection search, which
+ * requires one global sum for all groups per iteration, so the number of collective operations
+ * only grows with the logarithm of the number of parts.
+ *
+ * \param comm        the collective communication of all participating processes.
+ * \param centers     the coordinates of the local points.
+ * \param weights     the weights of the local points.
+ * \param parts       the number of parts.
+ * \param iterations  the number of bisection steps for each split coordinate.
+ */
+template<typename Communication, typename Coordinate>
+std::vector<int> recursiveCoordinateBisection(const Communication& comm,
+                                              const std::vector<Coordinate>& centers,
+                                              const std::vector<double>& weights,
+                                              int parts,
+                                              int iterations = 40)
+{
+  const int dim = Coordinate::dimension;
+  const std::size_t n = centers.size();
+  assert(weights.size() == n);
+
+  // groups of consecutive parts as (first part, number of parts), identical on all processes
+  std::vector<std::pair<int,int> > groups(1,std::make_pair(0,parts));
+  std::vector<std::size_t> group(n,0);
+
+  auto divisible = [](const std::pair<int,int>& g) { return g.second > 1; };
+  while (std::any_of(groups.begin(),groups.end(),divisible)) {
+    const std::size_t count = groups.size();
+
+    // bounding boxes and weights of all groups
+    std::vector<double> lower(count * dim,std::numeric_limits<double>::max());
+    std::vector<double> upper(count * dim,std::numeric_limits<double>::lowest());
+    std::vector<double> total(count,0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::size_t g = group[i];
+      for (int d = 0; d < dim; ++d) {
+        lower[g * dim + d] = std::min(lower[g * dim + d],double(centers[i][d]));
+        upper[g * dim + d] = std::max(upper[g * dim + d],double(centers[i][d]));
+      }
+      total[g] += weights[i];
+    }
+    comm.min(lower.data(),lower.size());
+    comm.max(upper.data(),upper.size());
+    comm.sum(total.data(),total.size());
+
+    std::vector<int> axis(count,0);
+    std::vector<double> lo(count), hi(count), target(count);
+    for (std::size_t g = 0; g < count; ++g) {
+      for (int d = 1; d < dim; ++d)
+        if (upper[g * dim + d] - lower[g * dim + d] > upper[g * dim + axis[g]] - lower[g * dim + axis[g]])
+          axis[g] = d;
+      lo[g] = lower[g * dim + axis[g]];
+      hi[g] = upper[g * dim + axis[g]];
+      target[g] = total[g] * (groups[g].second / 2) / groups[g].second;
+    }
+
+    // search the split coordinates of all groups at the same time
+    std::vector<double> below(count);
+    for (int it = 0; it < iterations; ++it) {
+      std::fill(below.begin(),below.end(),0.0);
+      for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t g = group[i];
+        if (centers[i][axis[g]] < 0.5 * (lo[g] + hi[g]))
+          below[g] += weights[i];
+      }
+      comm.sum(below.data(),below.size());
+      for (std::size_t g = 0; g < count; ++g) {
+        const double mid = 0.5 * (lo[g] + hi[g]);
+        if (below[g] < target[g])
+          lo[g] = mid;
+        else
+          hi[g] = mid;
+      }
+    }
+
+    // split the groups, points below the split coordinate go to the first half of the parts
+    std::vector<std::pair<int,int> > next;
+    std::vector<std::size_t> left(count), right(count);
+    for (std::size_t g = 0; g < count; ++g) {
+      const int first = groups[g].first;
+      const int size = groups[g].second;
+      left[g] = next.size();
+      if (size == 1) {
+        right[g] = left[g];
+        next.push_back(groups[g]);
+      } else {
+        next.emplace_back(first,size / 2);
+        right[g] = next.size();
+        next.emplace_back(first + size / 2,size - size / 2);
+      }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::size_t g = group[i];
+      group[i] = centers[i][axis[g]] < hi[g] ? left[g] : right[g];
+    }
+    groups = std::move(next);
+  }
+
+  std::vector<int> result(n);
+  for (std::size_t i = 0; i < n; ++i)
+    result[i] = groups[group[i]].first;
+  return result;
+}
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_LOADBALANCING_HH
@@ -0,0 +1,255 @@
+#ifndef DUNE_MULTIDOMAINGRID_MONOLITHICMCMGMAPPER_HH
+#define DUNE_MULTIDOMAINGRID_MONOLITHICMCMGMAPPER_HH
+
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/common/mcmgmapper.hh>
+
+#include <dune/grid/multidomaingrid/utility.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+/**
+ * @addtogroup Mapper
+ *
+ * @{
+ */
+
+//! Block layouts supported by MonolithicMCMGMapper.
+enum class MonolithicBlocking {
+  //! All indices of a subdomain are consecutive, subdomains are ordered by their index.
+  subDomainMajor,
+  //! The indices of an entity in all of its subdomains are consecutive.
+  interleaved
+};
+
+//! A single numbering of the entities of all subdomains of a MultiDomainGrid.
+/**
+ * MonolithicMCMGMapper maps every pair of a subdomain and an entity in that subdomain whose
+ * geometry type is selected by an MCMGLayout to a distinct index. Entities that belong to
+ * several subdomains thus receive one index per subdomain. This is the numbering required
+ * for monolithic solvers of coupled multi-physics problems.
+ *
+ * The order of the indices is selected by a MonolithicBlocking:
+ *
+ * - MonolithicBlocking::subDomainMajor numbers all entities of the first active subdomain,
+ *   then all entities of the second one and so on. Within a subdomain, the indices are ordered
+ *   like those of MultiDomainMCMGMapper. offset() returns the first index of each subdomain.
+ * - MonolithicBlocking::interleaved numbers the entities by geometry type and index in the
+ *   grid view. The indices of an entity in its subdomains are consecutive and ordered by
+ *   subdomain index, which keeps the couplings of a coupled matrix close to its diagonal.
+ *
+ * The mapper is built directly from the index maps of the MultiDomainGrid index set without
+ * traversing the grid. map() is a table lookup; in the interleaved layout it additionally scans
+ * the subdomain set of the entity, which is bounded by the number of subdomains per entity.
+ * The subdomain offsets are found through a util::SubDomainSlotMap, so their memory depends on
+ * the number of active subdomains, not on the magnitude of the subdomain indices.
+ *
+ * \note The numbering is local to each process. The mapper becomes invalid when the grid or
+ *       the subdomain layout is modified and has to be updated with update().
+ *
+ * \tparam GV  a leaf or level grid view of a MultiDomainGrid.
+ */
+template<typename GV>
+class MonolithicMCMGMapper
+{
+
+  typedef typename GV::Grid Grid;
+
+public:
+
+  typedef GV GridView;
+  typedef typename GV::IndexSet::IndexType IndexType;
+  typedef typename Grid::SubDomainIndex SubDomainIndex;
+  typedef typename GV::template Codim<0>::Entity Element;
+
+  static const int dimension = GV::dimension;
+
+  MonolithicMCMGMapper(const GV& gv, const MCMGLayout& layout, MonolithicBlocking blocking = MonolithicBlocking::subDomainMajor)
+    : _gridView(gv)
+    , _layout(layout)
+    , _blocking(blocking)
+  {
+    update(gv);
+  }
+
+  const GridView& gridView() const
+  {
+    return _gridView;
+  }
+
+  const MCMGLayout& layout() const
+  {
+    return _layout;
+  }
+
+  MonolithicBlocking blocking() const
+  {
+    return _blocking;
+  }
+
+  //! Returns the index of entity e in subDomain, which must contain e.
+  template<class EntityType>
+  IndexType map(SubDomainIndex subDomain, const EntityType& e) const
+  {
+    return lookup<EntityType::codimension>(subDomain,e.type(),_gridView.indexSet().index(e));
+  }
+
+  //! Returns the index of subentity i of codimension codim of e in subDomain, which must contain e.
+  IndexType map(SubDomainIndex subDomain, const Element& e, int i, unsigned int codim) const
+  {
+    const GeometryType gt = ReferenceElements<typename GV::ctype,dimension>::general(e.type()).type(i,codim);
+    const IndexType hostIndex = _gridView.indexSet().subIndex(e,i,codim);
+    IndexType result = 0;
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto cc){
+        if constexpr (Grid::MDGridTraits::template Codim<cc>::supported)
+          if (cc == int(codim))
+            result = this->template lookup<cc>(subDomain,gt,hostIndex);
+      });
+    return result;
+  }
+
+  //! Returns true and stores the index in result if entity e of subDomain is numbered by the mapper.
+  template<class EntityType>
+  bool contains(SubDomainIndex subDomain, const EntityType& e, IndexType& result) const
+  {
+    if (!_layout(e.type(),dimension) || !_gridView.indexSet().contains(subDomain,e)) {
+      result = 0;
+      return false;
+    }
+    result = map(subDomain,e);
+    return true;
+  }
+
+  //! Returns the total number of indices.
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+  //! Returns the number of indices of subDomain.
+  std::size_t size(SubDomainIndex subDomain) const
+  {
+    std::size_t result = 0;
+    for (int codim = 0; codim <= dimension; ++codim)
+      for (auto gt : _gridView.indexSet().types(subDomain,codim))
+        if (_layout(gt,dimension))
+          result += _gridView.indexSet().size(subDomain,gt);
+    return result;
+  }
+
+  //! Returns the first index of subDomain, only available for MonolithicBlocking::subDomainMajor.
+  std::size_t offset(SubDomainIndex subDomain) const
+  {
+    assert(_blocking == MonolithicBlocking::subDomainMajor);
+    const std::size_t s = slot(subDomain);
+    return s == noSlot ? _size : _offsets[s * _types];
+  }
+
+  //! Recalculates the numbering for the grid view gv.
+  void update(const GV& gv)
+  {
+    _gridView = gv;
+    const auto& indexSet = _gridView.indexSet();
+    _types = GlobalGeometryTypeIndex::size(dimension);
+    _offsets.clear();
+    _entityOffsets.clear();
+    _slots.clear();
+
+    if (_blocking == MonolithicBlocking::subDomainMajor) {
+      // one row of geometry type offsets per active subdomain, summed up across all rows
+      const auto& activeSubDomains = indexSet.activeSubDomains();
+      _slots.assign(activeSubDomains);
+      _offsets.assign(activeSubDomains.size() * _types + 1,0);
+      for (std::size_t s = 0; s < activeSubDomains.size(); ++s) {
+        const SubDomainIndex subDomain = activeSubDomains[s];
+        for (int codim = 0; codim <= dimension; ++codim)
+          for (auto gt : indexSet.types(subDomain,codim))
+            if (_layout(gt,dimension))
+              _offsets[s * _types + GlobalGeometryTypeIndex::index(gt) + 1] = indexSet.size(subDomain,gt);
+      }
+      std::partial_sum(_offsets.begin(),_offsets.end(),_offsets.begin());
+      _size = _offsets.back();
+    } else {
+      // reserve as many consecutive indices for each entity as it has subdomains
+      _entityOffsets.resize(_types);
+      IndexType next = 0;
+      Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+          if constexpr (Grid::MDGridTraits::template Codim<codim>::supported) {
+            for (auto gt : indexSet.types(codim)) {
+              if (!_layout(gt,dimension))
+                continue;
+              const auto& entries = indexSet.template indexMap<codim>()[LocalGeometryTypeIndex::index(gt)];
+              auto& offsets = _entityOffsets[GlobalGeometryTypeIndex::index(gt)];
+              offsets.resize(entries.size());
+              for (std::size_t i = 0; i < entries.size(); ++i) {
+                offsets[i] = next;
+                next += entries[i].domains.size();
+              }
+            }
+          }
+        });
+      _size = next;
+    }
+  }
+
+private:
+
+  static constexpr std::size_t noSlot = util::SubDomainSlotMap<SubDomainIndex>::noSlot;
+
+  std::size_t slot(SubDomainIndex subDomain) const
+  {
+    return _slots.slot(subDomain);
+  }
+
+  template<int codim>
+  IndexType lookup(SubDomainIndex subDomain, GeometryType gt, IndexType hostIndex) const
+  {
+    const auto& indexSet = _gridView.indexSet();
+    const auto& entry = indexSet.template indexMap<codim>()[LocalGeometryTypeIndex::index(gt)][hostIndex];
+    assert(entry.domains.contains(subDomain));
+    if (_blocking == MonolithicBlocking::interleaved) {
+      IndexType position = 0;
+      for (auto domain : entry.domains) {
+        if (domain == subDomain)
+          break;
+        ++position;
+      }
+      return _entityOffsets[GlobalGeometryTypeIndex::index(gt)][hostIndex] + position;
+    }
+    const IndexType index = entry.domains.simple()
+      ? entry.index
+      : indexSet.template multiIndexMap<codim>()[entry.index][entry.domains.domainOffset(subDomain)];
+    const std::size_t s = slot(subDomain);
+    assert(s != noSlot);
+    return _offsets[s * _types + GlobalGeometryTypeIndex::index(gt)] + index;
+  }
+
+  GridView _gridView;
+  MCMGLayout _layout;
+  MonolithicBlocking _blocking;
+  std::size_t _types = 0;
+  std::size_t _size = 0;
+  util::SubDomainSlotMap<SubDomainIndex> _slots; // subDomainMajor: row of each active subdomain in _offsets
+  std::vector<IndexType> _offsets; // subDomainMajor: offsets of all geometry types, one row per active subdomain
+  std::vector<std::vector<IndexType> > _entityOffsets; // interleaved: first index of every entity
+
+};
+
+/** @} */
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_MONOLITHICMCMGMAPPER_HH
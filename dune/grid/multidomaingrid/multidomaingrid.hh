@@ -1,8 +1,17 @@
 #ifndef DUNE_MULTIDOMAINGRID_MULTIDOMAINGRID_HH
 #define DUNE_MULTIDOMAINGRID_MULTIDOMAINGRID_HH
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <numeric>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <dune/common/shared_ptr.hh>
 
@@ -10,6 +19,8 @@
 
 #include <dune/grid/multidomaingrid/hostgridaccessor.hh>
 #include <dune/grid/multidomaingrid/subdomainset.hh>
+#include <dune/grid/multidomaingrid/subdomainsetencoding.hh>
+#include <dune/grid/multidomaingrid/loadbalancing.hh>
 
 #include <dune/grid/multidomaingrid/subdomaingrid/subdomaingrid.hh>
 
@@ -220,6 +231,19 @@ namespace Impl {
 
 //! A meta grid for dividing an existing DUNE grid into subdomains that can be accessed as a grid in their own right.
 /**
+ * <b>Thread safety</b>
+ *
+ * All const methods of a MultiDomainGrid and its SubDomainGrids may be called concurrently from
+ * multiple threads, as long as no thread modifies the grid at the same time. This includes access to
+ * index and id sets, entity and intersection iteration, subdomain interface iteration and
+ * subDomain(), which creates missing SubDomainGrids exactly once even if several threads request the
+ * same subdomain simultaneously. Caches that are built lazily on first use, like
+ * SubDomainGrid::compactGrid(), are protected as well.
+ *
+ * Methods that modify the grid (subdomain marking and updates, adaptation, load balancing) as well as
+ * communication must only be called from a single thread while no other thread accesses the grid.
+ * Entities, iterators and intersections must not be shared between threads without synchronization.
+ *
  * \tparam HostGrid             The type of the underlying grid implementation.
  * \tparam MDGridTraitsType     A traits type for customizing how the MultiDomainGrid manages the partitioning information.
  */
@@ -316,6 +340,12 @@ private:
   template<typename,typename,typename>
   friend class subdomain::IntersectionWrapper;
 
+  template<typename>
+  friend class subdomain::CommunicationInterfaces;
+
+  template<typename,typename>
+  friend class subdomain::AsyncCommunication;
+
   template<typename>
   friend class LeafGridView;
 
@@ -366,7 +396,8 @@ private:
 
   typedef std::map<typename Traits::LocalIdSet::IdType,typename MDGridTraits::template Codim<0>::SubDomainSet> AdaptationStateMap;
 
-  typedef std::map<typename Traits::GlobalIdSet::IdType,typename MDGridTraits::template Codim<0>::SubDomainSet> LoadBalanceStateMap;
+  //! The subdomains of the leaf cells during load balancing, sorted by global id once the host grid has been balanced.
+  typedef std::vector<std::pair<typename Traits::GlobalIdSet::IdType,typename MDGridTraits::template Codim<0>::SubDomainSet> > LoadBalanceState;
 
   // typedefs for extracting the host entity types from our own entities
 
@@ -441,7 +472,9 @@ public:
     _state(stateFixed),
     _adaptState(stateFixed),
     _supportLevelIndexSets(supportLevelIndexSets),
-    _maxAssignedSubDomainIndex(0)
+    _maxAssignedSubDomainIndex(0),
+    _globalSubDomainIndexing(false),
+    _subDomainCommunicators(false)
   {
     updateIndexSets();
   }
@@ -463,7 +496,9 @@ public:
     _state(stateFixed),
     _adaptState(stateFixed),
     _supportLevelIndexSets(supportLevelIndexSets),
-    _maxAssignedSubDomainIndex(0)
+    _maxAssignedSubDomainIndex(0),
+    _globalSubDomainIndexing(false),
+    _subDomainCommunicators(false)
   {
     updateIndexSets();
   }
@@ -747,6 +782,8 @@ public:
     _hostGrid.globalRefine(refCount);
     updateIndexSets();
     restoreMultiDomainState();
+    resetSubDomainRanks();
+    updateSubDomainGrids();
   }
 
   bool mark(int refCount, const typename Traits::template Codim<0>::Entity& e) {
@@ -773,6 +810,8 @@ public:
     bool result = _hostGrid.adapt();
     updateIndexSets();
     restoreMultiDomainState();
+    resetSubDomainRanks();
+    updateSubDomainGrids();
     return result;
   }
 
@@ -821,44 +860,148 @@ public:
     _hostGrid.leafGridView().communicate(datahandle,iftype,dir);
   }
 
+  //! The result of communicateAsync().
+  template<typename DataHandleImp, typename DataTypeImp>
+  using AsyncCommunicationType = subdomain::AsyncCommunication<GridImp,CommDataHandleIF<DataHandleImp,DataTypeImp> >;
+
+  //! Starts a non-blocking communication on the leaf view.
+  /**
+   * The data of all local entities is gathered immediately, and the received data is scattered
+   * when wait() is called on the returned object, or when it is destroyed. The communication
+   * interfaces of the leaf view are discovered during the first call for every codimension, which
+   * requires one blocking exchange across the host grid interface, and cached until the grid
+   * changes. See subdomain::AsyncCommunication for details.
+   */
+  template<typename DataHandleImp, typename DataTypeImp>
+  AsyncCommunicationType<DataHandleImp,DataTypeImp>
+  communicateAsync (CommDataHandleIF<DataHandleImp,DataTypeImp> &data,
+                    InterfaceType iftype,
+                    CommunicationDirection dir) const
+  {
+    // every rank starts the asynchronous communications of the grid in the same order, which keeps the tags consistent
+    const int tag = asyncCommunicationTagBase + (_asyncCommunications++ % asyncCommunicationTags) * (dimension + 1);
+    return AsyncCommunicationType<DataHandleImp,DataTypeImp>(*this,communicationInterfaces(),data,iftype,dir,tag);
+  }
+
   template<typename DataHandle>
   bool loadBalance(DataHandle& dataHandle)
   {
+    return loadBalanceWith(dataHandle,[&](auto& hostDataHandle) {
+        return _hostGrid.loadBalance(hostDataHandle);
+      });
+  }
+
+  bool loadBalance()
+  {
+    EmptyDataHandle emptyDataHandle;
+    return loadBalance(emptyDataHandle);
+  }
+
+  //! Balances the grid with cell weights that depend on the subdomains of the cells.
+  /**
+   * The weight of each leaf cell is computed from its subdomains by mdgrid::subDomainWeight(),
+   * so cost is either a container with the cost of a cell in every subdomain or a callable that
+   * maps a SubDomainSet to a weight. Cells in several subdomains are weighted with the sum of
+   * their costs.
+   *
+   * The interior cells of all processes are partitioned by a recursive coordinate bisection of
+   * their centers, and the resulting partition is passed to host grids that can be balanced to a
+   * given partition (see mdgrid::HasTargetPartitionLoadBalance), e.g. UGGrid. Other host grids
+   * cannot take the weights into account, so the grid is left unchanged and false is returned;
+   * call loadBalance() to balance them with their own, unweighted algorithm.
+   */
+  template<typename Cost, typename DataHandle>
+  bool weightedLoadBalance(const Cost& cost, DataHandle& dataHandle)
+  {
+    if constexpr (mdgrid::HasTargetPartitionLoadBalance<HostGrid,LoadBalancingDataHandle<DataHandle> >::value) {
+      const std::vector<int> targetRanks = weightedPartition(cost);
+      return loadBalanceWith(dataHandle,[&](auto& hostDataHandle) {
+          return _hostGrid.loadBalance(targetRanks,0u,hostDataHandle);
+        });
+    } else
+      return false;
+  }
+
+  template<typename Cost>
+  bool weightedLoadBalance(const Cost& cost)
+  {
+    EmptyDataHandle emptyDataHandle;
+    return weightedLoadBalance(cost,emptyDataHandle);
+  }
+
+  //! Computes the target rank of every leaf cell for weightedLoadBalance(), indexed by the host leaf index.
+  template<typename Cost>
+  std::vector<int> weightedPartition(const Cost& cost) const
+  {
+    const auto& hostIndexSet = _hostGrid.leafGridView().indexSet();
+    std::vector<int> targetRanks(hostIndexSet.size(0),comm().rank());
+    std::vector<typename HostGrid::template Codim<0>::Entity::Geometry::GlobalCoordinate> centers;
+    std::vector<double> weights;
+    std::vector<std::size_t> indices;
+    for (const auto& e : elements(leafGridView(),Partitions::interior)) {
+      centers.push_back(e.geometry().center());
+      weights.push_back(mdgrid::subDomainWeight(cost,_leafIndexSet.subDomains(e)));
+      indices.push_back(hostIndexSet.index(hostEntity(e)));
+    }
+    const std::vector<int> parts = mdgrid::recursiveCoordinateBisection(comm(),centers,weights,comm().size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      targetRanks[indices[i]] = parts[i];
+    return targetRanks;
+  }
+
+private:
+
+  //! Migrates the subdomains of the leaf cells while hostLoadBalance balances the host grid.
+  template<typename DataHandle, typename HostLoadBalance>
+  bool loadBalanceWith(DataHandle& dataHandle, HostLoadBalance&& hostLoadBalance)
+  {
+    assert(_state == stateFixed && _adaptState == stateFixed);
     typedef typename MultiDomainGrid::LeafGridView GV;
     GV gv = this->leafGridView();
-    typedef typename GV::template Codim<0>::Iterator Iterator;
-    typedef typename GV::template Codim<0>::Entity Entity;
-    typedef typename MDGridTraits::template Codim<0>::SubDomainSet SubDomainSet;
-    for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it) {
-      const Entity& e = *it;
-      const SubDomainSet& subDomains = gv.indexSet().subDomains(e);
-      _loadBalanceStateMap[globalIdSet().id(e)] = subDomains;
-    }
+
+    // cells that stay on this process are not passed to the data handle, so we have to remember
+    // the subdomains of all local cells; the data handle appends the cells it receives
+    _loadBalanceState.clear();
+    _loadBalanceState.reserve(gv.size(0));
+    for (const auto& e : elements(gv))
+      _loadBalanceState.emplace_back(globalIdSet().id(e),_leafIndexSet.subDomains(e));
 
     LoadBalancingDataHandle<DataHandle> dataHandleWrapper(*this,dataHandle);
-    if (!_hostGrid.loadBalance(dataHandleWrapper))
+    if (!hostLoadBalance(dataHandleWrapper)) {
+      _loadBalanceState.clear();
       return false;
+    }
 
-    this->startSubDomainMarking();
+    typedef typename LoadBalanceState::value_type Entry;
+    std::sort(_loadBalanceState.begin(),_loadBalanceState.end(),
+              [](const Entry& a, const Entry& b) { return a.first < b.first; });
 
-    for (Iterator it = gv.template begin<0>(); it != gv.template end<0>(); ++it) {
-      _leafIndexSet.addToSubDomains(_loadBalanceStateMap[globalIdSet().id(*it)],*it);
+    // restore the subdomains directly in the leaf index set and rebuild it in a single pass
+    resetCommunicationInterfaces();
+    updateLevelIndexSetCount();
+    _leafIndexSet.reset(true);
+    for (const auto& e : elements(gv)) {
+      const auto id = globalIdSet().id(e);
+      auto it = std::lower_bound(_loadBalanceState.begin(),_loadBalanceState.end(),id,
+                                 [](const Entry& entry, const decltype(id)& key) { return entry.first < key; });
+      // a cell may have been sent to this process by several others
+      for (; it != _loadBalanceState.end() && it->first == id; ++it)
+        _leafIndexSet.addToSubDomains(it->second,e);
     }
+    _leafIndexSet.update(_levelIndexSets,true);
+
+    _globalIdSet.update(_hostGrid.globalIdSet());
+    _localIdSet.update(_hostGrid.localIdSet());
 
-    this->preUpdateSubDomains();
-    this->updateSubDomains();
-    this->postUpdateSubDomains();
+    resetSubDomainRanks();
+    updateSubDomainGrids();
 
-    _loadBalanceStateMap.clear();
+    _loadBalanceState.clear();
 
     return true;
   }
 
-  bool loadBalance()
-  {
-    EmptyDataHandle emptyDataHandle;
-    return loadBalance(emptyDataHandle);
-  }
+public:
 
   size_t numBoundarySegments() const
   {
@@ -916,6 +1059,8 @@ public:
         _levelIndexSets[l]->swap(*_tmpLevelIndexSets[l]);
       }
     }
+    resetSubDomainRanks();
+    updateSubDomainGrids();
     _state = statePostUpdate;
   }
 
@@ -965,21 +1110,21 @@ public:
   /** @name Access to the subdomain grids */
   /*@{*/
   //! Returns a reference to the SubDomainGrid associated with the given subdomain.
+  /**
+   * The SubDomainGrid is created on first access. This method may safely be called from
+   * multiple threads at the same time.
+   */
   const SubDomainGrid& subDomain(SubDomainIndex subDomain) const {
-    std::shared_ptr<SubDomainGrid>& subGridPointer = _subDomainGrids[subDomain];
-    if (!subGridPointer) {
-      subGridPointer.reset(new SubDomainGrid(const_cast<MultiDomainGrid&>(*this),subDomain));
-    }
-    return *subGridPointer;
+    return subDomainGrid(subDomain);
   }
 
   //! Returns a reference to the SubDomainGrid associated with the given subdomain.
+  /**
+   * The SubDomainGrid is created on first access. This method may safely be called from
+   * multiple threads at the same time.
+   */
   SubDomainGrid& subDomain(SubDomainIndex subDomain) {
-    std::shared_ptr<SubDomainGrid>& subGridPointer = _subDomainGrids[subDomain];
-    if (!subGridPointer) {
-      subGridPointer.reset(new SubDomainGrid(*this,subDomain));
-    }
-    return *subGridPointer;
+    return subDomainGrid(subDomain);
   }
 
   //! Returns the largest subdomain index that was ever assigned to a cell in this grid.
@@ -994,6 +1139,92 @@ public:
     return _maxAssignedSubDomainIndex;
   }
 
+  //! An edge of the subdomain adjacency graph, see subDomainGraph().
+  typedef typename LeafIndexSetImp::SubDomainGraphEdge SubDomainGraphEdge;
+
+  //! Returns the adjacency graph of the subdomains on the leaf level.
+  /**
+   * The graph lists all pairs of subdomains that share at least one leaf entity together with
+   * the number of shared entities per codimension. It is updated together with the subdomain
+   * indices and therefore costs no extra grid traversal.
+   */
+  const std::vector<SubDomainGraphEdge>& subDomainGraph() const {
+    return _leafIndexSet.subDomainGraph();
+  }
+
+  //! Returns the number of leaf entities of codimension codim shared by two subdomains.
+  typename LeafIndexSetImp::IndexType sharedEntities(SubDomainIndex subDomain1, SubDomainIndex subDomain2, int codim) const {
+    return _leafIndexSet.sharedEntities(subDomain1,subDomain2,codim);
+  }
+
+  //! Returns the indices of all subdomains that contain at least one leaf entity, in ascending order.
+  const std::vector<SubDomainIndex>& activeSubDomains() const {
+    return _leafIndexSet.activeSubDomains();
+  }
+
+  //! Enables or disables process-wide consistent subdomain indices on the leaf index set.
+  /**
+   * If enabled, every update of the leaf subdomain layout (updateSubDomains(), adapt() and
+   * loadBalance()) additionally numbers the entities of each subdomain consecutively across all
+   * processes, see IndexSetWrapper::globalIndex(). This requires two collective communications
+   * over the host grid and a global reduction of the per-subdomain sizes, so the update has to be
+   * carried out on all processes. The setting takes effect with the next update.
+   */
+  void setGlobalSubDomainIndexing(bool enabled) {
+    _globalSubDomainIndexing = enabled;
+  }
+
+  //! Indicates whether process-wide consistent subdomain indices are computed.
+  bool globalSubDomainIndexing() const {
+    return _globalSubDomainIndexing;
+  }
+
+  //! Returns the ranks that hold at least one leaf entity of the given subdomain, in ascending order.
+  /**
+   * Ranks count as soon as they hold any leaf entity of the subdomain, including overlap and
+   * ghost entities. The ranks of a subdomain are determined by a single reduction on the first
+   * call for that subdomain after every update of the leaf subdomain layout (updateSubDomains(),
+   * adapt() and loadBalance()), so only the subdomains that are asked for cost communication and
+   * memory. This first call is collective over all processes, which have to ask for the ranks of
+   * several subdomains in the same order.
+   *
+   * \note The returned span stays valid until the next update of the leaf subdomain layout.
+   */
+  util::Span<const int> subDomainRanks(SubDomainIndex subDomain) const {
+    std::lock_guard<std::mutex> lock(_subDomainRanksMutex);
+    auto it = _subDomainRanks.find(subDomain);
+    if (it == _subDomainRanks.end())
+      it = _subDomainRanks.emplace(subDomain,gatherSubDomainRanks(subDomain)).first;
+    return util::Span<const int>(it->second.data(),it->second.data() + it->second.size());
+  }
+
+  //! Enables or disables separate communicators for the SubDomainGrids.
+  /**
+   * If enabled, SubDomainGrid::comm() returns a communicator that only contains the ranks in
+   * subDomainRanks() instead of the communicator of the host grid, so collective operations of
+   * a subdomain solver do not involve uninvolved processes. On all other ranks, it returns an
+   * empty communicator. The communicator is created on the first call to comm() after every
+   * update of the subdomain layout; like the first call to subDomainRanks(), this call is
+   * collective over all processes, which must request the communicators of several subdomains
+   * in the same order.
+   *
+   * The setting only has an effect for parallel host grids that communicate through MPI.
+   */
+  void setSubDomainCommunicators(bool enabled) {
+    _subDomainCommunicators = enabled;
+#if HAVE_MPI
+    // only the communicators depend on this setting, all other caches stay valid
+    for (auto& subGridPair : _subDomainGrids)
+      if (subGridPair.second->grid)
+        subGridPair.second->grid->resetCommunicator();
+#endif
+  }
+
+  //! Indicates whether the SubDomainGrids use separate communicators, see setSubDomainCommunicators().
+  bool subDomainCommunicators() const {
+    return _subDomainCommunicators;
+  }
+
   //! Indicates whether this MultiDomainGrid instance supports level index sets on its SubDomainGrids.
   bool supportLevelIndexSets() const {
     return _supportLevelIndexSets;
@@ -1059,13 +1290,49 @@ private:
   State _adaptState;
   const bool _supportLevelIndexSets;
 
-  mutable std::map<SubDomainIndex,std::shared_ptr<SubDomainGrid> > _subDomainGrids;
+  //! Storage for a lazily created SubDomainGrid.
+  struct SubDomainGridSlot
+  {
+    std::once_flag created;
+    std::unique_ptr<SubDomainGrid> grid;
+  };
+
+  mutable std::map<SubDomainIndex,std::unique_ptr<SubDomainGridSlot> > _subDomainGrids;
+  mutable std::mutex _subDomainGridsMutex;
   SubDomainIndex _maxAssignedSubDomainIndex;
+  bool _globalSubDomainIndexing;
+  bool _subDomainCommunicators;
+  mutable std::mutex _subDomainRanksMutex;
+  mutable std::map<SubDomainIndex,std::vector<int> > _subDomainRanks;
+
+  mutable std::mutex _communicationInterfacesMutex;
+  mutable std::unique_ptr<subdomain::CommunicationInterfaces<GridImp> > _communicationInterfaces;
+#if HAVE_MPI
+  mutable std::once_flag _messageCommunicatorCreated;
+  mutable std::unique_ptr<subdomain::DuplicateCommunicator> _messageCommunicator;
+#endif
+
+  //! MPI tags used by communicateAsync(), one block of dimension + 1 tags per pending communication.
+  static const int asyncCommunicationTagBase = 16384;
+  static const int asyncCommunicationTags = 1024;
+  mutable unsigned int _asyncCommunications = 0;
 
   AdaptationStateMap _adaptationStateMap;
-  LoadBalanceStateMap _loadBalanceStateMap;
+  LoadBalanceState _loadBalanceState;
 
   void updateIndexSets() {
+    resetCommunicationInterfaces();
+    updateLevelIndexSetCount();
+
+    _leafIndexSet.reset(true);
+    _leafIndexSet.update(_levelIndexSets,true);
+
+    _globalIdSet.update(_hostGrid.globalIdSet());
+    _localIdSet.update(_hostGrid.localIdSet());
+  }
+
+  //! Creates or removes LevelIndexSets to match the number of levels of the host grid.
+  void updateLevelIndexSetCount() {
     // make sure we have enough LevelIndexSets
     if (_supportLevelIndexSets) {
       while (static_cast<int>(_levelIndexSets.size()) <= maxLevel()) {
@@ -1077,16 +1344,88 @@ private:
           _levelIndexSets.resize(maxLevel() + 1);
         }
     }
+  }
 
-    _leafIndexSet.reset(true);
-    _leafIndexSet.update(_levelIndexSets,true);
+  //! Determines the ranks holding leaf entities of the given subdomain with a single reduction.
+  std::vector<int> gatherSubDomainRanks(SubDomainIndex subDomain) const {
+    const auto& c = comm();
+    const auto& active = activeSubDomains();
+    std::vector<unsigned char> present(c.size(),0);
+    present[c.rank()] = std::binary_search(active.begin(),active.end(),subDomain);
+    c.max(present.data(),c.size());
+    std::vector<int> ranks;
+    for (int rank = 0; rank < c.size(); ++rank)
+      if (present[rank])
+        ranks.push_back(rank);
+    return ranks;
+  }
 
-    _globalIdSet.update(_hostGrid.globalIdSet());
-    _localIdSet.update(_hostGrid.localIdSet());
+  //! Discards the ranks of all subdomains after the leaf subdomain layout has changed.
+  void resetSubDomainRanks() {
+    std::lock_guard<std::mutex> lock(_subDomainRanksMutex);
+    _subDomainRanks.clear();
+  }
+
+  //! Returns the communication interfaces of the leaf view, creating them if necessary.
+  const subdomain::CommunicationInterfaces<GridImp>& communicationInterfaces() const {
+    std::lock_guard<std::mutex> lock(_communicationInterfacesMutex);
+    if (!_communicationInterfaces)
+      _communicationInterfaces = std::make_unique<subdomain::CommunicationInterfaces<GridImp> >(*this);
+    return *_communicationInterfaces;
+  }
+
+  //! Discards the communication interfaces after the leaf view has changed.
+  void resetCommunicationInterfaces() {
+    std::lock_guard<std::mutex> lock(_communicationInterfacesMutex);
+    _communicationInterfaces.reset();
+  }
 
-    // rebuild level index sets on subgrids
+#if HAVE_MPI
+  //! Returns the private duplicate of the host communicator used by communicateAsync().
+  /**
+   * The first call is collective over all ranks. The communicator is kept for the lifetime of the grid.
+   */
+  MPI_Comm messageCommunicator() const {
+    std::call_once(_messageCommunicatorCreated,[&](){
+        _messageCommunicator = std::make_unique<subdomain::DuplicateCommunicator>(comm());
+      });
+    return *_messageCommunicator;
+  }
+#endif
+
+  //! The grid itself, this allows CommunicationInterfaces to treat it like a SubDomainGrid.
+  const MultiDomainGrid& multiDomainGrid() const {
+    return *this;
+  }
+
+  //! All host entities belong to the MultiDomainGrid, see SubDomainGrid::containsHostEntity().
+  template<typename EntityType>
+  bool containsHostEntity(const EntityType& e) const {
+    return true;
+  }
+
+  //! Refreshes the SubDomainGrids after the subdomain layout has been finalized.
+  void updateSubDomainGrids() {
     for (auto& subGridPair : _subDomainGrids)
-      subGridPair.second->update();
+      if (subGridPair.second->grid)
+        subGridPair.second->grid->update();
+  }
+
+  SubDomainGrid& subDomainGrid(SubDomainIndex subDomain) const {
+    SubDomainGridSlot* slot = nullptr;
+    {
+      // only hold the lock while looking up the slot, so that different subdomains can be
+      // created in parallel; map nodes are stable, so the slot stays valid after unlocking
+      std::lock_guard<std::mutex> lock(_subDomainGridsMutex);
+      auto& slotPointer = _subDomainGrids[subDomain];
+      if (!slotPointer)
+        slotPointer = std::make_unique<SubDomainGridSlot>();
+      slot = slotPointer.get();
+    }
+    std::call_once(slot->created,[&](){
+        slot->grid.reset(new SubDomainGrid(const_cast<MultiDomainGrid&>(*this),subDomain));
+      });
+    return *slot->grid;
   }
 
   void saveMultiDomainState() {
@@ -1209,14 +1548,10 @@ private:
                                     >
   {
 
-    union Data
-    {
-      SubDomainIndex data;
-      typename WrappedDataHandle::DataType buffer;
-    };
+    typedef typename WrappedDataHandle::DataType DataType;
 
-    static_assert(sizeof(Data) >= sizeof(SubDomainIndex),
-                  "During load balancing, the data type has to be large enough to contain MultiDomaingrid::SubDomainIndex");
+    static_assert(std::is_trivially_copyable<DataType>::value,
+                  "During load balancing, the subdomains are packed into the data type of the wrapped data handle, which therefore has to be trivially copyable");
 
     bool contains(int dim, int codim) const
     {
@@ -1233,7 +1568,7 @@ private:
     std::size_t size(const Entity& e) const
     {
       if (_grid.leafGridView().indexSet().contains(e) && e.partitionType() == Dune::InteriorEntity)
-        return _grid.leafGridView().indexSet().subDomains(e).size() + 1 + _wrappedDataHandle.size(e);
+        return mdgrid::util::encodedSubDomainsItems<DataType>(_grid.leafGridView().indexSet().subDomains(e)) + _wrappedDataHandle.size(e);
       else
         return _wrappedDataHandle.size(e);
     }
@@ -1244,14 +1579,8 @@ private:
       assert(Entity::codimension == 0);
       if (e.partitionType() == Dune::InteriorEntity && _grid.leafGridView().indexSet().contains(e))
         {
-          const auto& subDomains = _grid.leafGridView().indexSet().subDomains(e);
-          Data size = { subDomains.size() };
-          buf.write(size.buffer);
-          for (auto& sub_domain : subDomains)
-            {
-              Data subDomain = { sub_domain };
-              buf.write(subDomain.buffer);
-            }
+          // the subdomains are sent as their encoded length followed by the encoded set
+          mdgrid::util::writeSubDomainItems<DataType>(buf,_grid.leafGridView().indexSet().subDomains(e));
         }
       _wrappedDataHandle.gather(buf,e);
     }
@@ -1261,15 +1590,10 @@ private:
     {
       if (e.partitionType() != Dune::InteriorEntity && _grid.leafGridView().indexSet().contains(e))
         {
-          Data subDomains = { 0 };
-          buf.read(subDomains.buffer);
-          for (int i = 0; i < subDomains.data; ++i)
-            {
-              Data subDomain = { 0 };
-              buf.read(subDomain.buffer);
-              _grid._loadBalanceStateMap[_grid.globalIdSet().id(multiDomainEntity(e))].add(subDomain.data);
-            }
-          _wrappedDataHandle.scatter(buf,e,n - (subDomains.data + 1));
+          typename MDGridTraits::template Codim<0>::SubDomainSet subDomains;
+          const std::size_t items = mdgrid::util::readSubDomainItems<DataType,SubDomainIndex>(buf,[&](SubDomainIndex subDomain) { subDomains.add(subDomain); });
+          _grid._loadBalanceState.emplace_back(_grid.globalIdSet().id(multiDomainEntity(e)),subDomains);
+          _wrappedDataHandle.scatter(buf,e,n - items);
         }
       else
         _wrappedDataHandle.scatter(buf,e,n);
@@ -1,12 +1,20 @@
 #ifndef DUNE_MULTIDOMAINGRID_MULTDIDOMAINMCMGMAPPER_HH
 #define DUNE_MULTIDOMAINGRID_MULTDIDOMAINMCMGMAPPER_HH
 
+#include <array>
+#include <cassert>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <vector>
 
+#include <dune/common/exceptions.hh>
+#include <dune/grid/common/capabilities.hh>
 #include <dune/grid/common/mcmgmapper.hh>
 #include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/multidomaingrid/utility.hh>
 
 namespace Dune {
 
@@ -18,41 +26,6 @@ namespace mdgrid {
  * @{
  */
 
-namespace {
-
-  template<typename GV, bool max_subomain_index_is_static>
-  struct MCMGMapperStorageProvider
-  {
-
-  protected:
-
-    typedef typename GV::IndexSet::IndexType IndexType;
-
-    void update(const GV& gv) {}
-
-    std::array<std::vector<IndexType>,GV::Grid::maxSubDomainIndex()> _offsets; // provide a map with all geometry types
-
-  };
-
-  template<typename GV>
-  struct MCMGMapperStorageProvider<GV,false>
-  {
-
-  protected:
-
-    typedef typename GV::IndexSet::IndexType IndexType;
-
-    void update(const GV& gv) {
-      _offsets.resize(gv.grid().maxSubDomainIndex());
-    }
-
-    std::vector<std::vector<IndexType> > _offsets; // provide a map with all geometry types
-
-  };
-
-
-}
-
 /** @brief Implementation class for a multiple codim and multiple geometry type mapper.
  *
  * In this implementation of a mapper the entity set used as domain for the map consists
@@ -80,19 +53,25 @@ namespace {
  *
  * If you don't want to use the default constructor of the LayoutClass you can construct it yourself
  * and hand it to the respective constructor.
+ *
+ * The mapper only stores offsets for the active subdomains of the grid view, i.e. the
+ * subdomains that contain at least one entity of the grid view. On a parallel grid, this
+ * includes subdomains that only contain lower-dimensional entities on the local process. The
+ * offsets of all active subdomains are kept in a single table, whose rows are found through a
+ * util::SubDomainSlotMap in constant time, so the memory and the cost of update() depend on the
+ * number of active subdomains, not on maxSubDomainIndex(). An inactive subdomain has size 0
+ * and contains no entities, and map() must not be called for it.
+ *
+ * The geometry types of all subentities of each cell geometry type are tabulated during
+ * update(), so mapping a subentity does not need to consult the reference element. For grids
+ * with a single geometry type, the table of the cell type is selected at compile time.
  */
 template <typename GV>
-class MultiDomainMCMGMapper : public MultipleCodimMultipleGeomTypeMapper<GV>,
-                              public MCMGMapperStorageProvider<GV,GV::Grid::maxSubDomainIndexIsStatic()>
-
+class MultiDomainMCMGMapper : public MultipleCodimMultipleGeomTypeMapper<GV>
 {
 
   typedef MultipleCodimMultipleGeomTypeMapper<GV> Base;
 
-  typedef MCMGMapperStorageProvider<GV,GV::Grid::maxSubDomainIndexIsStatic()> StorageProvider;
-
-  using StorageProvider::_offsets;
-
 public:
 
   typedef typename GV::IndexSet::IndexType IndexType;
@@ -126,7 +105,8 @@ public:
   template<class EntityType>
   int map (SubDomainIndex subDomain, const EntityType& e) const
   {
-    return gridView().indexSet().index(subDomain,e) + _offsets[subDomain][GlobalGeometryTypeIndex::index(e.type())];
+    const IndexType first = offset(subDomain,e.type());
+    return gridView().indexSet().index(subDomain,e) + first;
   }
 
   /** @brief Map subentity of codim 0 entity to array index.
@@ -138,11 +118,9 @@ public:
   */
   int map (SubDomainIndex subDomain, const typename GV::template Codim<0>::Entity& e, int i, unsigned int codim) const
   {
-    GeometryType gt =
-        ReferenceElements<double, GV::dimension>::general(e.type()).type(i,
-                                                                         codim);
-    return gridView().indexSet().subIndex(subDomain, e, i, codim) +
-           _offsets[subDomain][GlobalGeometryTypeIndex::index(gt)];
+    const SubEntityType& se = subEntityType(e,i,codim);
+    const IndexType first = offset(subDomain,se.typeIndex);
+    return gridView().indexSet().subIndex(subDomain, e, i, codim, se.type) + first;
   }
 
   /** @brief Return total number of entities in the entity set managed by the mapper.
@@ -155,7 +133,14 @@ public:
   */
   int size (SubDomainIndex subDomain) const
   {
-    return _offsets[subDomain].back();
+    const std::size_t s = slot(subDomain);
+    return s == noSlot ? 0 : _offsets[(s + 1) * _stride - 1];
+  }
+
+  //! Returns the subdomains with at least one entity of any codimension in the grid view, in ascending order.
+  const std::vector<SubDomainIndex>& activeSubDomains() const
+  {
+    return _activeSubDomains;
   }
 
   /** @brief Returns true if the entity is contained in the index set
@@ -186,15 +171,14 @@ public:
   template<int cc> // this is now the subentity's codim
   bool contains (SubDomainIndex subDomain, const typename GV::template Codim<0>::Entity& e, int i, IndexType& result) const
   {
-    GeometryType gt = ReferenceElements<double,GV::dimension>::general(e.type()).type(i,cc);
+    const SubEntityType& se = subEntityType(e,i,cc);
     // if the entity is contained in the subdomain, all of its subentities are contained as well
     if (!gridView().indexSet().contains(subDomain, e) ||
-        !Base::layout()(gt, GV::dimension)) {
+        !Base::layout()(se.type, GV::dimension)) {
       result = 0;
       return false;
     }
-    result = gridView().indexSet().subIndex(subDomain, e, i, cc) +
-             _offsets[subDomain][GlobalGeometryTypeIndex::index(gt)];
+    result = gridView().indexSet().subIndex(subDomain, e, i, cc, se.type) + offset(subDomain,se.typeIndex);
     return true;
   }
 
@@ -214,26 +198,93 @@ public:
   void update(const GV& gv)
   {
     static_cast<Base*>(this)->update(gv);
-    StorageProvider::update(gv);
-    for (SubDomainIndex subDomain = 0;
-         subDomain < gridView().grid().maxSubDomainIndex(); ++subDomain) {
-      std::vector<IndexType>& offsets = _offsets[subDomain];
-      offsets.resize(GlobalGeometryTypeIndex::size(GV::dimension) + 1);
-      std::fill(offsets.begin(),offsets.end(),0);
+    const auto& indexSet = gridView().indexSet();
+    _activeSubDomains = indexSet.activeSubDomains();
+    _slots.assign(_activeSubDomains);
+    _stride = GlobalGeometryTypeIndex::size(GV::dimension) + 1;
+    _offsets.assign(_activeSubDomains.size() * _stride,0);
+
+    // tabulate the subentity geometry types of all cell geometry types
+    _subEntityTypes.assign(singleGeometryType ? 1 : LocalGeometryTypeIndex::size(GV::dimension),SubEntityTypes());
+    for (auto cellType : indexSet.types(0)) {
+      const auto& refElement = ReferenceElements<typename GV::ctype,GV::dimension>::general(cellType);
+      auto& table = _subEntityTypes[cellTypeSlot(cellType)];
+      for (int cc = 0; cc <= GV::dimension; ++cc) {
+        table[cc].resize(refElement.size(cc));
+        for (int i = 0; i < refElement.size(cc); ++i)
+          table[cc][i] = SubEntityType{refElement.type(i,cc),GlobalGeometryTypeIndex::index(refElement.type(i,cc))};
+      }
+    }
+
+    for (std::size_t s = 0; s < _activeSubDomains.size(); ++s) {
+      const SubDomainIndex subDomain = _activeSubDomains[s];
+      const auto offsets = _offsets.begin() + s * _stride;
 
       // Compute offsets for the different geometry types.
       // Note that mapper becomes invalid when the grid is modified.
       for (int cc = 0; cc <= GV::dimension; ++cc)
-        {
-          for (auto gt : gridView().indexSet().types(subDomain,cc))
-            offsets[GlobalGeometryTypeIndex::index(gt) + 1] =
-                gridView().indexSet().size(subDomain, gt);
-          // convert sizes to offset
-          // last entry stores total size
-          std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
-        }
+        for (auto gt : indexSet.types(subDomain,cc))
+          offsets[GlobalGeometryTypeIndex::index(gt) + 1] = indexSet.size(subDomain, gt);
+      // convert sizes to offset
+      // last entry stores total size
+      std::partial_sum(offsets,offsets + _stride,offsets);
     }
   }
+
+private:
+
+  static constexpr std::size_t noSlot = util::SubDomainSlotMap<SubDomainIndex>::noSlot;
+
+  std::size_t slot(SubDomainIndex subDomain) const
+  {
+    return _slots.slot(subDomain);
+  }
+
+  IndexType offset(SubDomainIndex subDomain, GeometryType gt) const
+  {
+    return offset(subDomain,GlobalGeometryTypeIndex::index(gt));
+  }
+
+  IndexType offset(SubDomainIndex subDomain, std::size_t typeIndex) const
+  {
+    const std::size_t s = slot(subDomain);
+    assert(s != noSlot && "the subdomain has no entities in the grid view of the mapper");
+    return _offsets[s * _stride + typeIndex];
+  }
+
+  static constexpr bool singleGeometryType = Capabilities::hasSingleGeometryType<typename GV::Grid>::v;
+
+  //! The geometry type of a subentity together with its GlobalGeometryTypeIndex.
+  struct SubEntityType
+  {
+    GeometryType type;
+    std::size_t typeIndex;
+  };
+
+  typedef std::array<std::vector<SubEntityType>,GV::dimension+1> SubEntityTypes;
+
+  static std::size_t cellTypeSlot(const GeometryType& gt)
+  {
+    if constexpr (singleGeometryType)
+      return 0;
+    else
+      return LocalGeometryTypeIndex::index(gt);
+  }
+
+  const SubEntityType& subEntityType(const typename GV::template Codim<0>::Entity& e, int i, int codim) const
+  {
+    if constexpr (singleGeometryType)
+      return _subEntityTypes[0][codim][i];
+    else
+      return _subEntityTypes[LocalGeometryTypeIndex::index(e.type())][codim][i];
+  }
+
+  std::vector<SubDomainIndex> _activeSubDomains;
+  util::SubDomainSlotMap<SubDomainIndex> _slots; // row of each active subdomain in _offsets
+  std::size_t _stride = 0;
+  std::vector<IndexType> _offsets; // offsets of all geometry types, one row per active subdomain
+  std::vector<SubEntityTypes> _subEntityTypes; // subentity geometry types per cell geometry type
+
 };
 
 /** @} */
@@ -0,0 +1,178 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_ADJACENCY_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_ADJACENCY_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/grid/multidomaingrid/subdomaingrid/compressedrows.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Adjacency tables of the leaf view of a SubDomainGrid in compressed row format.
+/**
+ * The tables are restricted to the subdomain and use the subdomain leaf index space. Entities
+ * of codimension 0 and 1 are numbered by their subdomain index, with the indices of different
+ * geometry types stacked on top of each other in the order of LocalGeometryTypeIndex; see
+ * cellIndex() and faceIndex(). For grids with a single geometry type per codimension, these
+ * numbers are equal to the subdomain leaf indices. Vertices are numbered by their subdomain
+ * leaf index.
+ *
+ * All rows are returned as spans pointing into the tables, so no data is copied.
+ *
+ * The face tables are only built if the MDGridTraits of the grid support codimension 1. Otherwise,
+ * faces(), faceIndex() and cellFaces() cannot be used.
+ *
+ * \note The tables are obtained through SubDomainGrid::leafAdjacency() or the adjacency() method
+ *       of the SubDomainGrid leaf grid view. They are discarded
+ *       when the subdomain layout changes or the grid is modified, so references to them must
+ *       not be held across MultiDomainGrid::updateSubDomains(), MultiDomainGrid::adapt(),
+ *       MultiDomainGrid::globalRefine() and MultiDomainGrid::loadBalance().
+ *
+ * \tparam IndexType  the index type of the subdomain index set.
+ * \tparam hasFaces   whether the subdomain index set supports codimension 1.
+ */
+template<typename IndexType, bool hasFaces = true>
+class SubDomainAdjacency
+{
+
+public:
+
+  typedef typename CompressedRows<IndexType>::Row Row;
+
+  //! Builds the adjacency tables for the leaf grid view gv of a SubDomainGrid.
+  template<typename GV>
+  explicit SubDomainAdjacency(const GV& gv)
+  {
+    const int dimension = GV::dimension;
+    const auto& indexSet = gv.indexSet();
+
+    _cellOffsets = geometryTypeOffsets<std::size_t>(indexSet,0,dimension);
+    if constexpr (hasFaces)
+      _faceOffsets = geometryTypeOffsets<std::size_t>(indexSet,1,dimension);
+
+    const std::size_t cellCount = _cellOffsets.back();
+    std::vector<std::pair<IndexType,IndexType> > vertexCells;
+    _cellFaces.setupRows(cellCount);
+    _cellNeighbors.setupRows(cellCount);
+
+    // count faces and neighbors per cell
+    for (const auto& cell : elements(gv)) {
+      const std::size_t c = cellIndex(cell.type(),indexSet.index(cell));
+      if constexpr (hasFaces)
+        _cellFaces.addToRow(c,cell.subEntities(1));
+      for (const auto& intersection : intersections(gv,cell))
+        if (intersection.neighbor())
+          _cellNeighbors.addToRow(c);
+      const unsigned int corners = cell.subEntities(dimension);
+      for (unsigned int i = 0; i < corners; ++i)
+        vertexCells.emplace_back(indexSet.subIndex(cell,i,dimension),c);
+    }
+
+    // fill faces and neighbors
+    _cellFaces.allocate();
+    _cellNeighbors.allocate();
+    for (const auto& cell : elements(gv)) {
+      const std::size_t c = cellIndex(cell.type(),indexSet.index(cell));
+      if constexpr (hasFaces) {
+        const auto refElement = referenceElement(cell.geometry());
+        const auto faces = _cellFaces.row(c);
+        for (std::size_t i = 0; i < faces.size(); ++i)
+          faces[i] = faceIndex(refElement.type(i,1),indexSet.subIndex(cell,i,1));
+      }
+      auto neighbor = _cellNeighbors.row(c).begin();
+      for (const auto& intersection : intersections(gv,cell))
+        if (intersection.neighbor()) {
+          const auto outside = intersection.outside();
+          *neighbor++ = cellIndex(outside.type(),indexSet.index(outside));
+        }
+    }
+
+    // vertex to cell table, rows sorted by cell number
+    std::sort(vertexCells.begin(),vertexCells.end());
+    _vertexCells.setupRows(indexSet.size(dimension));
+    for (const auto& vertexCell : vertexCells)
+      _vertexCells.addToRow(vertexCell.first);
+    _vertexCells.allocate();
+    for (std::size_t i = 0; i < vertexCells.size(); ++i)
+      _vertexCells[i] = vertexCells[i].second;
+  }
+
+  //! Returns the number of cells.
+  std::size_t cells() const
+  {
+    return _cellOffsets.back();
+  }
+
+  //! Returns the number of faces.
+  std::size_t faces() const
+  {
+    static_assert(hasFaces,"the face tables require support for codimension 1 in the MDGridTraits");
+    return _faceOffsets.back();
+  }
+
+  //! Returns the number of vertices.
+  std::size_t vertices() const
+  {
+    return _vertexCells.rows();
+  }
+
+  //! Returns the number of the cell with the given geometry type and subdomain index.
+  std::size_t cellIndex(const GeometryType& gt, IndexType index) const
+  {
+    return _cellOffsets[LocalGeometryTypeIndex::index(gt)] + index;
+  }
+
+  //! Returns the number of the face with the given geometry type and subdomain index.
+  std::size_t faceIndex(const GeometryType& gt, IndexType index) const
+  {
+    static_assert(hasFaces,"the face tables require support for codimension 1 in the MDGridTraits");
+    return _faceOffsets[LocalGeometryTypeIndex::index(gt)] + index;
+  }
+
+  //! Returns the numbers of all cells of the subdomain containing vertex v, in ascending order.
+  Row vertexCells(std::size_t v) const
+  {
+    return _vertexCells.row(v);
+  }
+
+  //! Returns the numbers of all cells of the subdomain sharing a face with cell c.
+  Row cellNeighbors(std::size_t c) const
+  {
+    return _cellNeighbors.row(c);
+  }
+
+  //! Returns the face numbers of cell c, ordered by the local face number.
+  Row cellFaces(std::size_t c) const
+  {
+    static_assert(hasFaces,"the face tables require support for codimension 1 in the MDGridTraits");
+    return _cellFaces.row(c);
+  }
+
+private:
+
+  std::vector<std::size_t> _cellOffsets;
+  std::vector<std::size_t> _faceOffsets;
+  CompressedRows<IndexType> _vertexCells;
+  CompressedRows<IndexType> _cellNeighbors;
+  CompressedRows<IndexType> _cellFaces;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_ADJACENCY_HH
@@ -0,0 +1,856 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMMUNICATION_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMMUNICATION_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/hybridutilities.hh>
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/multidomaingrid/utility.hh>
+
+#if HAVE_MPI
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+#include <dune/common/parallel/variablesizecommunicator.hh>
+#endif
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+namespace detail {
+
+  //! Returns true if entities with partition type pt send data in a forward communication over iftype.
+  inline bool isInterfaceSource(InterfaceType iftype, PartitionType pt)
+  {
+    switch (iftype)
+      {
+      case InteriorBorder_InteriorBorder_Interface:
+      case InteriorBorder_All_Interface:
+        return pt == InteriorEntity || pt == BorderEntity;
+      case Overlap_OverlapFront_Interface:
+      case Overlap_All_Interface:
+        return pt == InteriorEntity || pt == BorderEntity || pt == OverlapEntity;
+      default:
+        return true;
+      }
+  }
+
+  //! Returns true if entities with partition type pt receive data in a forward communication over iftype.
+  inline bool isInterfaceTarget(InterfaceType iftype, PartitionType pt)
+  {
+    switch (iftype)
+      {
+      case InteriorBorder_InteriorBorder_Interface:
+        return pt == InteriorEntity || pt == BorderEntity;
+      case Overlap_OverlapFront_Interface:
+        return pt == InteriorEntity || pt == BorderEntity || pt == OverlapEntity || pt == FrontEntity;
+      default:
+        return true;
+      }
+  }
+
+} // namespace detail
+
+
+//! Communication interfaces of a SubDomainGrid leaf view.
+/**
+ * This class records, for every entity of a subdomain that has copies on other ranks, the ranks
+ * and partition types of those copies, provided that the copies belong to the subdomain as well.
+ * From this information it derives per-rank send and receive lists for every InterfaceType, which
+ * only contain entities of the subdomain and leave out ranks that do not share any part of it.
+ * Data is then exchanged with a VariableSizeCommunicator, so the cost of a communication scales
+ * with the parallel boundary of the subdomain instead of that of the whole grid.
+ *
+ * The interfaces are discovered per codimension the first time data on that codimension is
+ * communicated, which requires a single exchange across the complete host grid interface. As
+ * communicate() is collective, this guarantees that all ranks take part in the discovery, even if
+ * they have not created the SubDomainGrid before. The cached interfaces are discarded whenever the
+ * SubDomainGrid is updated.
+ *
+ * All messages are exchanged over a private duplicate of the host communicator, which is owned by
+ * the grid and created during the first discovery. Communications of different subdomains thus
+ * cannot receive each other's messages, even if they use the same tags.
+ *
+ * \tparam GridImp  the SubDomainGrid, or the MultiDomainGrid for communication on its leaf view.
+ */
+template<typename GridImp>
+class CommunicationInterfaces
+{
+
+  using Grid = std::remove_const_t<GridImp>;
+  using HostGrid = typename Grid::HostGrid;
+
+  static const int dimension = Grid::dimension;
+
+public:
+
+  //! The number of different interface types defined by Dune::InterfaceType.
+  static const std::size_t interfaceTypes = 5;
+
+  //! A connection between a local entity and a copy of it on another rank.
+  struct Link
+  {
+    //! The rank holding the remote copy.
+    int rank;
+    //! The position of the local entity in CodimInterfaces::seeds.
+    std::size_t entity;
+    //! The partition type of the local entity.
+    PartitionType localPartitionType;
+    //! The partition type of the remote copy.
+    PartitionType remotePartitionType;
+  };
+
+#if HAVE_MPI
+  using InterfaceMap = typename VariableSizeCommunicator<>::InterfaceMap;
+#endif
+
+  //! The interface information for a single codimension.
+  template<int codim>
+  struct CodimInterfaces
+  {
+
+    using EntitySeed = typename Grid::Traits::template Codim<codim>::EntitySeed;
+
+    //! Set to true once the interfaces for this codimension have been discovered.
+    bool valid = false;
+
+    //! Seeds of all entities with remote copies in the subdomain, ordered by their global id.
+    std::vector<EntitySeed> seeds;
+
+    //! All links of the entities in seeds, ordered by rank and by entity.
+    std::vector<Link> links;
+
+#if HAVE_MPI
+    //! Lazily built send and receive lists, indexed by InterfaceType.
+    std::array<std::unique_ptr<InterfaceMap>,interfaceTypes> interfaceMaps;
+#endif
+
+    void clear()
+    {
+      valid = false;
+      seeds.clear();
+      links.clear();
+#if HAVE_MPI
+      for (auto& interfaceMap : interfaceMaps)
+        if (interfaceMap)
+          {
+            // InterfaceInformation does not release its memory on destruction
+            for (auto& rankInterfaces : *interfaceMap)
+              {
+                rankInterfaces.second.first.free();
+                rankInterfaces.second.second.free();
+              }
+            interfaceMap.reset();
+          }
+#endif
+    }
+
+    ~CodimInterfaces()
+    {
+      clear();
+    }
+
+  };
+
+private:
+
+  template<int... codims>
+  static std::tuple<CodimInterfaces<codims>...> codimInterfacesTuple(std::integer_sequence<int,codims...>);
+
+  using CodimInterfacesTuple = decltype(codimInterfacesTuple(std::make_integer_sequence<int,dimension+1>()));
+
+public:
+
+  explicit CommunicationInterfaces(const Grid& grid)
+    : _grid(grid)
+  {}
+
+  CommunicationInterfaces(const CommunicationInterfaces&) = delete;
+  CommunicationInterfaces& operator=(const CommunicationInterfaces&) = delete;
+
+  //! Discards all cached interfaces.
+  void reset()
+  {
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        std::get<codim>(_codimInterfaces).clear();
+      });
+  }
+
+  //! Returns the interface information for the given codimension, discovering it if necessary.
+  /**
+   * \note The first call for a given codimension is collective.
+   */
+  template<int codim>
+  const CodimInterfaces<codim>& codimInterfaces() const
+  {
+    auto& interfaces = std::get<codim>(_codimInterfaces);
+    if (!interfaces.valid)
+      discover<codim>(interfaces);
+    return interfaces;
+  }
+
+  //! Returns true if an entity of a codimension communicated by data has a copy on any rank.
+  /**
+   * On a single rank, such copies only exist if the host grid has periodic boundaries.
+   *
+   * \note The first call for a given codimension is collective.
+   */
+  template<typename DataHandle>
+  bool hasInterfaces(const DataHandle& data) const
+  {
+    bool result = false;
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        if (data.contains(dimension,codim) && !codimInterfaces<codim>().links.empty())
+          result = true;
+      });
+    return result;
+  }
+
+#if HAVE_MPI
+
+  //! Returns the private communicator for the messages of the grid.
+  /**
+   * \note The communicator is created during the first discovery of an interface. If no interface
+   *       has been discovered yet, this call is collective over all ranks of the host grid.
+   */
+  MPI_Comm communicator() const
+  {
+    return _grid.messageCommunicator();
+  }
+
+  //! Returns the send and receive lists for forward communication over iftype.
+  /**
+   * The first list of each entry contains the positions in CodimInterfaces::seeds that are sent to
+   * the rank, the second one the positions that are received from it. Ranks without entries in
+   * both lists are omitted.
+   */
+  template<int codim>
+  const InterfaceMap& interfaceMap(InterfaceType iftype) const
+  {
+    const auto& interfaces = codimInterfaces<codim>();
+    auto& interfaceMap = std::get<codim>(_codimInterfaces).interfaceMaps[iftype];
+    if (!interfaceMap)
+      interfaceMap = buildInterfaceMap(interfaces.links,iftype);
+    return *interfaceMap;
+  }
+
+#endif
+
+  //! Communicates the data of handle across the subdomain interfaces.
+  /**
+   * Returns false if communication over the cached interfaces is not possible for the underlying
+   * grid, in which case the caller has to fall back to communicating over the host grid. This is
+   * also the case on a single rank if the host grid has periodic boundaries.
+   */
+  template<typename DataHandle>
+  bool communicate(DataHandle& data, InterfaceType iftype, CommunicationDirection dir) const
+  {
+#if HAVE_MPI
+    using Communication = std::decay_t<decltype(_grid.multiDomainGrid().comm())>;
+    if constexpr (std::is_same_v<Communication,Dune::Communication<MPI_Comm> >)
+      {
+        // a single rank only has to communicate across the periodic boundaries of the host grid,
+        // which the host grid handles itself
+        if (_grid.multiDomainGrid().comm().size() == 1)
+          return !hasInterfaces(data);
+        const MPI_Comm comm = communicator();
+        Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+            if (!data.contains(dimension,codim))
+              return;
+            IndexedDataHandle<DataHandle,codim> indexedData(data,_grid,codimInterfaces<codim>().seeds);
+            VariableSizeCommunicator<> communicator(comm,interfaceMap<codim>(iftype));
+            if (dir == ForwardCommunication)
+              communicator.forward(indexedData);
+            else
+              communicator.backward(indexedData);
+          });
+        return true;
+      }
+    else
+#endif
+      return false;
+  }
+
+private:
+
+#if HAVE_MPI
+
+  //! Adapts a grid data handle to the index-based interface of VariableSizeCommunicator.
+  template<typename DataHandle, int codim>
+  struct IndexedDataHandle
+  {
+
+    using DataType = typename DataHandle::DataType;
+    using EntitySeed = typename CodimInterfaces<codim>::EntitySeed;
+
+    bool fixedSize() const
+    {
+      return false;
+    }
+
+    bool fixedsize() const
+    {
+      return false;
+    }
+
+    std::size_t size(std::size_t i) const
+    {
+      return _data.size(_grid.entity(_seeds[i]));
+    }
+
+    template<typename MessageBuffer>
+    void gather(MessageBuffer& buf, std::size_t i) const
+    {
+      _data.gather(buf,_grid.entity(_seeds[i]));
+    }
+
+    template<typename MessageBuffer>
+    void scatter(MessageBuffer& buf, std::size_t i, std::size_t n)
+    {
+      _data.scatter(buf,_grid.entity(_seeds[i]),n);
+    }
+
+    IndexedDataHandle(DataHandle& data, const Grid& grid, const std::vector<EntitySeed>& seeds)
+      : _data(data)
+      , _grid(grid)
+      , _seeds(seeds)
+    {}
+
+    DataHandle& _data;
+    const Grid& _grid;
+    const std::vector<EntitySeed>& _seeds;
+
+  };
+
+  static std::unique_ptr<InterfaceMap> buildInterfaceMap(const std::vector<Link>& links, InterfaceType iftype)
+  {
+    // count first, as InterfaceInformation needs to know its size in advance
+    std::map<int,std::pair<std::size_t,std::size_t> > counts;
+    for (const auto& link : links)
+      {
+        auto& count = counts[link.rank];
+        if (detail::isInterfaceSource(iftype,link.localPartitionType) && detail::isInterfaceTarget(iftype,link.remotePartitionType))
+          ++count.first;
+        if (detail::isInterfaceTarget(iftype,link.localPartitionType) && detail::isInterfaceSource(iftype,link.remotePartitionType))
+          ++count.second;
+      }
+
+    auto interfaceMap = std::make_unique<InterfaceMap>();
+    for (const auto& count : counts)
+      {
+        if (count.second.first == 0 && count.second.second == 0)
+          continue;
+        auto& rankInterfaces = (*interfaceMap)[count.first];
+        rankInterfaces.first.reserve(count.second.first);
+        rankInterfaces.second.reserve(count.second.second);
+      }
+
+    for (const auto& link : links)
+      {
+        auto it = interfaceMap->find(link.rank);
+        if (it == interfaceMap->end())
+          continue;
+        if (detail::isInterfaceSource(iftype,link.localPartitionType) && detail::isInterfaceTarget(iftype,link.remotePartitionType))
+          it->second.first.add(link.entity);
+        if (detail::isInterfaceTarget(iftype,link.localPartitionType) && detail::isInterfaceSource(iftype,link.remotePartitionType))
+          it->second.second.add(link.entity);
+      }
+
+    return interfaceMap;
+  }
+
+#endif
+
+  template<int codim>
+  struct DiscoveryDataHandle
+    : public CommDataHandleIF<DiscoveryDataHandle<codim>,int>
+  {
+
+    using HostEntitySeed = typename HostGrid::template Codim<codim>::EntitySeed;
+    using IdType = typename HostGrid::Traits::GlobalIdSet::IdType;
+
+    struct Record
+    {
+      IdType id;
+      HostEntitySeed seed;
+      int rank;
+      PartitionType localPartitionType;
+      PartitionType remotePartitionType;
+    };
+
+    bool contains(int dim, int cd) const
+    {
+      return cd == codim;
+    }
+
+    bool fixedSize(int dim, int cd) const
+    {
+      return false;
+    }
+
+    template<typename Entity>
+    std::size_t size(const Entity& e) const
+    {
+      return _grid.containsHostEntity(e) ? 2 : 0;
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void gather(MessageBuffer& buf, const Entity& e) const
+    {
+      if (_grid.containsHostEntity(e))
+        {
+          buf.write(_rank);
+          buf.write(static_cast<int>(e.partitionType()));
+        }
+    }
+
+    template<typename MessageBuffer, typename Entity>
+    void scatter(MessageBuffer& buf, const Entity& e, std::size_t n)
+    {
+      if (n == 0)
+        return;
+      int rank = 0;
+      int remotePartitionType = 0;
+      buf.read(rank);
+      buf.read(remotePartitionType);
+      if (_grid.containsHostEntity(e))
+        _records.push_back({
+            _grid.multiDomainGrid()._hostGrid.globalIdSet().id(e),
+            e.seed(),
+            rank,
+            e.partitionType(),
+            static_cast<PartitionType>(remotePartitionType)
+          });
+    }
+
+    DiscoveryDataHandle(const Grid& grid)
+      : _grid(grid)
+      , _rank(grid.multiDomainGrid().comm().rank())
+    {}
+
+    const Grid& _grid;
+    const int _rank;
+    std::vector<Record> _records;
+
+  };
+
+  template<int codim>
+  void discover(CodimInterfaces<codim>& interfaces) const
+  {
+    interfaces.clear();
+
+#if HAVE_MPI
+    // the discovery is collective, so this is where the private communicator can be created
+    using Communication = std::decay_t<decltype(_grid.multiDomainGrid().comm())>;
+    if constexpr (std::is_same_v<Communication,Dune::Communication<MPI_Comm> >)
+      if (_grid.multiDomainGrid().comm().size() > 1)
+        communicator();
+#endif
+
+    DiscoveryDataHandle<codim> discoveryData(_grid);
+    _grid.multiDomainGrid()._hostGrid.leafGridView().communicate(discoveryData,All_All_Interface,ForwardCommunication);
+
+    auto& records = discoveryData._records;
+    std::sort(records.begin(),records.end(),[](const auto& a, const auto& b){
+        return a.id < b.id || (!(b.id < a.id) && a.rank < b.rank);
+      });
+
+    interfaces.links.reserve(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i)
+      {
+        if (i == 0 || records[i-1].id != records[i].id)
+          interfaces.seeds.emplace_back(records[i].seed);
+        interfaces.links.push_back({
+            records[i].rank,
+            interfaces.seeds.size() - 1,
+            records[i].localPartitionType,
+            records[i].remotePartitionType
+          });
+      }
+
+    // both sides of an interface must traverse the shared entities in the same order, which is
+    // guaranteed by sorting the entities of every rank by their global id
+    std::stable_sort(interfaces.links.begin(),interfaces.links.end(),[](const Link& a, const Link& b){
+        return a.rank < b.rank;
+      });
+
+    interfaces.valid = true;
+  }
+
+  const Grid& _grid;
+  mutable CodimInterfacesTuple _codimInterfaces;
+
+};
+
+
+//! A non-blocking communication on the leaf view of a SubDomainGrid.
+/**
+ * The data of all local entities is gathered into per-rank buffers and sent by non-blocking MPI
+ * sends when the communication is started. The messages are transferred while the caller
+ * continues to work, and test() can be called to progress them. The received data is passed to
+ * the data handle in wait(), which is also called by the destructor.
+ *
+ * Only the entities and ranks of the cached CommunicationInterfaces take part in the
+ * communication. If those cannot be used, the communication is carried out by a blocking call
+ * to SubDomainGrid::communicate() when it is started, and wait() does nothing.
+ *
+ * The messages are sent over the private communicator of the grid, see
+ * CommunicationInterfaces::communicator(), with a tag that is unique among the pending
+ * communications of the grid. Pending communications of different grids, e.g. of several
+ * subdomains, can therefore be completed in any order.
+ *
+ * \note The data handle and the grid must not be modified before wait() has returned.
+ *       Like communicate(), starting the communication is collective, and all ranks have to
+ *       start the asynchronous communications of a grid in the same order.
+ *
+ * \tparam GridImp     the SubDomainGrid or the MultiDomainGrid.
+ * \tparam DataHandle  the type of the data handle.
+ */
+template<typename GridImp, typename DataHandle>
+class AsyncCommunication
+{
+
+  using Grid = std::remove_const_t<GridImp>;
+
+  static const int dimension = Grid::dimension;
+
+public:
+
+  //! Starts the communication, this is what communicateAsync() of the grids calls.
+  AsyncCommunication(const Grid& grid, const CommunicationInterfaces<GridImp>& interfaces,
+                     DataHandle& data, InterfaceType iftype, CommunicationDirection dir, int tag)
+    : _grid(&grid)
+    , _interfaces(&interfaces)
+    , _data(&data)
+  {
+#if HAVE_MPI
+    using Communication = std::decay_t<decltype(grid.multiDomainGrid().comm())>;
+    if constexpr (std::is_same_v<Communication,Dune::Communication<MPI_Comm> >)
+      {
+        // a single rank can only communicate across periodic boundaries of the host grid,
+        // which the blocking communication leaves to the host grid
+        if (grid.multiDomainGrid().comm().size() == 1)
+          {
+            grid.communicate(data,iftype,dir);
+            return;
+          }
+        const MPI_Comm comm = interfaces.communicator();
+        Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+            if (!data.contains(dimension,codim))
+              return;
+            const auto& seeds = interfaces.template codimInterfaces<codim>().seeds;
+            for (const auto& rankInterfaces : interfaces.template interfaceMap<codim>(iftype))
+              {
+                const auto& send = dir == ForwardCommunication ? rankInterfaces.second.first : rankInterfaces.second.second;
+                const auto& receive = dir == ForwardCommunication ? rankInterfaces.second.second : rankInterfaces.second.first;
+                if (send.size() > 0)
+                  {
+                    _sends.emplace_back();
+                    Message& message = _sends.back();
+                    for (std::size_t k = 0; k < send.size(); ++k)
+                      {
+                        const auto e = grid.entity(seeds[send[k]]);
+                        message.buffer.write(std::size_t(data.size(e)));
+                        data.gather(message.buffer,e);
+                      }
+                    MPI_Isend(message.buffer.data(),static_cast<int>(message.buffer.size()),MPI_BYTE,
+                              rankInterfaces.first,tag + codim,comm,&message.request);
+                  }
+                if (receive.size() > 0)
+                  {
+                    _receives[codim].emplace_back();
+                    Message& message = _receives[codim].back();
+                    message.rank = rankInterfaces.first;
+                    message.tag = tag + codim;
+                    message.entities = &receive;
+                  }
+              }
+          });
+        _comm = comm;
+        _pending = true;
+        return;
+      }
+#endif
+    // the cached interfaces cannot be used, communicate immediately
+    grid.communicate(data,iftype,dir);
+  }
+
+  AsyncCommunication(AsyncCommunication&& other)
+    : _grid(other._grid)
+    , _interfaces(other._interfaces)
+    , _data(other._data)
+    , _pending(std::exchange(other._pending,false))
+  {
+#if HAVE_MPI
+    _comm = other._comm;
+    _sends = std::move(other._sends);
+    _receives = std::move(other._receives);
+#endif
+  }
+
+  AsyncCommunication& operator=(AsyncCommunication&& other) = delete;
+
+  ~AsyncCommunication()
+  {
+    wait();
+  }
+
+  //! Progresses the communication and returns true if all data has been received.
+  bool test()
+  {
+    if (!_pending)
+      return true;
+    bool complete = true;
+#if HAVE_MPI
+    for (auto& messages : _receives)
+      for (auto& message : messages)
+        if (!message.received)
+          {
+            int flag = 0;
+            MPI_Status status;
+            MPI_Iprobe(message.rank,message.tag,_comm,&flag,&status);
+            if (flag)
+              receive(message,status);
+            else
+              complete = false;
+          }
+    for (auto& message : _sends)
+      if (message.request != MPI_REQUEST_NULL)
+        {
+          int flag = 0;
+          MPI_Test(&message.request,&flag,MPI_STATUS_IGNORE);
+          complete = complete && flag;
+        }
+#endif
+    return complete;
+  }
+
+  //! Waits for all messages and passes the received data to the data handle.
+  void wait()
+  {
+    if (!_pending)
+      return;
+    _pending = false;
+#if HAVE_MPI
+    Hybrid::forEach(std::make_integer_sequence<int,dimension+1>(),[&](auto codim){
+        if (_receives[codim].empty())
+          return;
+        const auto& seeds = _interfaces->template codimInterfaces<codim>().seeds;
+        for (auto& message : _receives[codim])
+          {
+            if (!message.received)
+              {
+                MPI_Status status;
+                MPI_Probe(message.rank,message.tag,_comm,&status);
+                receive(message,status);
+              }
+            for (std::size_t k = 0; k < message.entities->size(); ++k)
+              {
+                std::size_t n = 0;
+                message.buffer.read(n);
+                _data->scatter(message.buffer,_grid->entity(seeds[(*message.entities)[k]]),n);
+              }
+          }
+      });
+    for (auto& message : _sends)
+      MPI_Wait(&message.request,MPI_STATUS_IGNORE);
+#endif
+  }
+
+private:
+
+  //! A message buffer that stores the objects of the data handle and entity sizes as raw bytes.
+  struct Buffer
+  {
+
+    template<typename T>
+    void write(const T& value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,"asynchronous communication requires trivially copyable data");
+      const std::size_t offset = _bytes.size();
+      _bytes.resize(offset + sizeof(T));
+      std::memcpy(_bytes.data() + offset,&value,sizeof(T));
+    }
+
+    template<typename T>
+    void read(T& value)
+    {
+      assert(_pos + sizeof(T) <= _bytes.size());
+      std::memcpy(&value,_bytes.data() + _pos,sizeof(T));
+      _pos += sizeof(T);
+    }
+
+    char* data()
+    {
+      return _bytes.data();
+    }
+
+    std::size_t size() const
+    {
+      return _bytes.size();
+    }
+
+    void resize(std::size_t size)
+    {
+      _bytes.resize(size);
+      _pos = 0;
+    }
+
+    std::vector<char> _bytes;
+    std::size_t _pos = 0;
+
+  };
+
+#if HAVE_MPI
+
+  struct Message
+  {
+    int rank = 0;
+    int tag = 0;
+    Buffer buffer;
+    MPI_Request request = MPI_REQUEST_NULL;
+    bool received = false;
+    //! The positions of the received entities in CodimInterfaces::seeds.
+    const InterfaceInformation* entities = nullptr;
+  };
+
+  void receive(Message& message, const MPI_Status& status)
+  {
+    int count = 0;
+    MPI_Get_count(&status,MPI_BYTE,&count);
+    message.buffer.resize(count);
+    MPI_Recv(message.buffer.data(),count,MPI_BYTE,message.rank,message.tag,_comm,MPI_STATUS_IGNORE);
+    message.received = true;
+  }
+
+  MPI_Comm _comm = MPI_COMM_NULL;
+  // std::deque keeps the buffers in place while their sends are in flight
+  std::deque<Message> _sends;
+  std::array<std::vector<Message>,dimension+1> _receives;
+
+#endif
+
+  const Grid* _grid;
+  const CommunicationInterfaces<GridImp>* _interfaces;
+  DataHandle* _data;
+  bool _pending = false;
+
+};
+
+#if HAVE_MPI
+
+//! Owns a duplicate of an MPI communicator.
+/**
+ * Messages sent on the duplicate are never matched by receives on the original communicator or
+ * on other duplicates of it. The duplication is collective over all ranks of the original.
+ */
+class DuplicateCommunicator
+{
+
+public:
+
+  explicit DuplicateCommunicator(MPI_Comm comm)
+  {
+    MPI_Comm_dup(comm,&_comm);
+  }
+
+  DuplicateCommunicator(const DuplicateCommunicator&) = delete;
+  DuplicateCommunicator& operator=(const DuplicateCommunicator&) = delete;
+
+  ~DuplicateCommunicator()
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (_comm != MPI_COMM_NULL && !finalized)
+      MPI_Comm_free(&_comm);
+  }
+
+  operator MPI_Comm() const
+  {
+    return _comm;
+  }
+
+private:
+
+  MPI_Comm _comm = MPI_COMM_NULL;
+
+};
+
+//! Owns the MPI communicator of the ranks that hold entities of one subdomain.
+/**
+ * The communicator is created with MPI_Comm_create_group(), so only the ranks of the subdomain
+ * take part in its creation. All other ranks get an empty communicator with size 0 and rank -1.
+ * See MultiDomainGrid::setSubDomainCommunicators().
+ */
+class SubDomainCommunicator
+{
+
+public:
+
+  typedef Dune::Communication<MPI_Comm> Communication;
+
+  //! Creates the communicator of the given ascending ranks of comm, collective over these ranks.
+  SubDomainCommunicator(const Communication& comm, util::Span<const int> ranks, int tag)
+    : _comm(create(comm,ranks,tag))
+    , _communication(_comm)
+  {}
+
+  SubDomainCommunicator(const SubDomainCommunicator&) = delete;
+  SubDomainCommunicator& operator=(const SubDomainCommunicator&) = delete;
+
+  ~SubDomainCommunicator()
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (_comm != MPI_COMM_NULL && !finalized)
+      MPI_Comm_free(&_comm);
+  }
+
+  const Communication& communication() const
+  {
+    return _communication;
+  }
+
+private:
+
+  static MPI_Comm create(const Communication& comm, util::Span<const int> ranks, int tag)
+  {
+    if (!std::binary_search(ranks.begin(),ranks.end(),comm.rank()))
+      return MPI_COMM_NULL;
+    MPI_Group group, subGroup;
+    MPI_Comm_group(comm,&group);
+    MPI_Group_incl(group,int(ranks.size()),ranks.begin(),&subGroup);
+    MPI_Comm result = MPI_COMM_NULL;
+    MPI_Comm_create_group(comm,subGroup,tag,&result);
+    MPI_Group_free(&subGroup);
+    MPI_Group_free(&group);
+    return result;
+  }
+
+  MPI_Comm _comm;
+  Communication _communication;
+
+};
+
+#endif
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMMUNICATION_HH
@@ -0,0 +1,244 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPACTGRID_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPACTGRID_HH
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/rangeutilities.hh>
+#include <dune/common/reservedvector.hh>
+
+#include <dune/geometry/multilineargeometry.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/grid/multidomaingrid/utility.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/compressedrows.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/facetable.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! A standalone, contiguous copy of the leaf view of a SubDomainGrid.
+/**
+ * CompactSubDomainGrid materializes the cells of a subdomain once, storing vertex coordinates,
+ * cell-to-vertex connectivity, per-face neighbor tables and intersection types in flat arrays.
+ * Iterating over it does not touch the SubDomainGrid, the MultiDomainGrid or the host grid, which
+ * makes it well suited for solver phases that repeatedly sweep the same small subdomain.
+ *
+ * Cells are numbered by their subdomain leaf index, with the indices of different geometry types
+ * stacked on top of each other in the order of LocalGeometryTypeIndex. For grids with a single
+ * geometry type, the compact cell number thus equals the subdomain leaf index. Vertices are
+ * numbered by their subdomain leaf index.
+ *
+ * Each compact grid keeps entity seeds of its cells, so it is always possible to go back to
+ * the corresponding entities of the SubDomainGrid and the MultiDomainGrid.
+ *
+ * \note Compact grids are obtained through SubDomainGrid::compactGrid(). They are discarded
+ *       when the subdomain layout changes (MultiDomainGrid::updateSubDomains()) or the grid is
+ *       modified (MultiDomainGrid::adapt(), MultiDomainGrid::globalRefine(),
+ *       MultiDomainGrid::loadBalance()), so references to them must not be held across these calls.
+ *
+ * \note Only conforming leaf views are supported.
+ *
+ * \tparam GV  the leaf grid view of a SubDomainGrid.
+ */
+template<typename GV>
+class CompactSubDomainGrid
+{
+
+public:
+
+  using GridView         = GV;
+  using Grid             = typename GV::Grid;
+  using IndexType        = typename GV::IndexSet::IndexType;
+  using ctype            = typename Grid::ctype;
+  using IntersectionType = typename Grid::IntersectionType;
+
+  static const int dimension      = GV::dimension;
+  static const int dimensionworld = GV::dimensionworld;
+
+  using GlobalCoordinate = FieldVector<ctype,dimensionworld>;
+  using Entity           = typename GV::template Codim<0>::Entity;
+  using EntitySeed       = typename Entity::EntitySeed;
+
+  //! Geometry traits that store the corners in place instead of in a std::vector.
+  struct GeometryTraits
+    : public MultiLinearGeometryTraits<ctype>
+  {
+    template<int mydim, int cdim>
+    struct CornerStorage
+    {
+      typedef ReservedVector<FieldVector<ctype,cdim>,(1 << mydim)> Type;
+    };
+  };
+
+  using Geometry = MultiLinearGeometry<ctype,dimension,dimensionworld,GeometryTraits>;
+
+  //! Marker returned by neighbor() for faces without a neighbor inside the subdomain.
+  static constexpr IndexType noNeighbor = std::numeric_limits<IndexType>::max();
+
+  //! Builds the compact representation of the given subdomain leaf grid view.
+  explicit CompactSubDomainGrid(const GV& gv)
+    : _gridView(gv)
+  {
+    const auto& indexSet = gv.indexSet();
+
+    // the face table also provides the numbering of the cells
+    _faces.setup(gv,Face{noNeighbor,Grid::boundary});
+
+    const IndexType cellCount = _faces.cells();
+    _cellTypes.resize(cellCount);
+    _cellSeeds.resize(cellCount);
+    _cellVertices.setupRows(cellCount);
+    _vertices.resize(indexSet.size(dimension));
+
+    // first pass: collect per-cell sizes
+    for (const auto& cell : elements(gv)) {
+      const IndexType c = index(cell);
+      _cellTypes[c] = cell.type();
+      _cellSeeds[c] = cell.seed();
+      _cellVertices.addToRow(c,cell.subEntities(dimension));
+    }
+    _cellVertices.allocate();
+
+    // second pass: fill in connectivity, coordinates and neighbor tables
+    for (const auto& cell : elements(gv)) {
+      const IndexType c = index(cell);
+      const auto geo = cell.geometry();
+      const auto corners = _cellVertices.row(c);
+      for (std::size_t i = 0; i < corners.size(); ++i) {
+        const IndexType v = indexSet.subIndex(cell,i,dimension);
+        corners[i] = v;
+        _vertices[v] = geo.corner(i);
+      }
+      for (const auto& intersection : intersections(gv,cell)) {
+        if (!intersection.conforming())
+          DUNE_THROW(NotImplemented,"CompactSubDomainGrid does not support non-conforming intersections");
+        Face& face = _faces[_faces.slot(c,intersection.indexInInside())];
+        face.type = gv.grid().intersectionType(intersection);
+        if (intersection.neighbor())
+          face.neighbor = index(intersection.outside());
+      }
+    }
+  }
+
+  //! Returns the number of cells (codim == 0) or vertices (codim == dimension).
+  IndexType size(int codim) const {
+    if (codim == 0)
+      return _cellTypes.size();
+    if (codim == dimension)
+      return _vertices.size();
+    DUNE_THROW(NotImplemented,"CompactSubDomainGrid only stores cells and vertices");
+  }
+
+  //! Returns a range over all cell numbers.
+  IntegralRange<IndexType> cells() const {
+    return IntegralRange<IndexType>(0,_cellTypes.size());
+  }
+
+  //! Returns the compact number of the given subdomain cell.
+  IndexType index(const Entity& e) const {
+    return _faces.cellIndex(_gridView.indexSet(),e);
+  }
+
+  //! Returns the GeometryType of cell c.
+  GeometryType type(IndexType c) const {
+    return _cellTypes[c];
+  }
+
+  //! Returns the geometry of cell c, constructed from the stored vertex coordinates.
+  Geometry geometry(IndexType c) const {
+    ReservedVector<GlobalCoordinate,(1 << dimension)> corners;
+    for (auto v : cellVertices(c))
+      corners.push_back(_vertices[v]);
+    return Geometry(_cellTypes[c],corners);
+  }
+
+  //! Returns the coordinates of vertex v.
+  const GlobalCoordinate& vertex(IndexType v) const {
+    return _vertices[v];
+  }
+
+  //! Returns the vertex numbers of cell c in reference element order.
+  util::Span<const IndexType> cellVertices(IndexType c) const {
+    return _cellVertices.row(c);
+  }
+
+  //! Returns the number of faces of cell c.
+  int faces(IndexType c) const {
+    return _faces.faces(c);
+  }
+
+  //! Returns the cell on the other side of face f of cell c or noNeighbor.
+  IndexType neighbor(IndexType c, int f) const {
+    return _faces[_faces.slot(c,f)].neighbor;
+  }
+
+  //! Returns the intersection type of face f of cell c as defined by SubDomainGrid::IntersectionType.
+  IntersectionType intersectionType(IndexType c, int f) const {
+    return _faces[_faces.slot(c,f)].type;
+  }
+
+  //! Returns true if face f of cell c lies on the boundary of the subdomain.
+  /**
+   * This includes both the boundary of the host grid and faces shared with cells outside the
+   * subdomain, in line with SubDomainGrid intersections.
+   */
+  bool boundary(IndexType c, int f) const {
+    const IntersectionType type = intersectionType(c,f);
+    return type == Grid::boundary || type == Grid::foreign;
+  }
+
+  //! Returns the SubDomainGrid entity of cell c.
+  Entity entity(IndexType c) const {
+    return _gridView.grid().entity(_cellSeeds[c]);
+  }
+
+  //! Returns the MultiDomainGrid entity of cell c.
+  typename Grid::MultiDomainGrid::Traits::template Codim<0>::Entity multiDomainEntity(IndexType c) const {
+    return _gridView.grid().multiDomainGrid().entity(_cellSeeds[c]);
+  }
+
+  //! Returns the entity seed of cell c.
+  const EntitySeed& seed(IndexType c) const {
+    return _cellSeeds[c];
+  }
+
+  const GridView& gridView() const {
+    return _gridView;
+  }
+
+private:
+
+  struct Face
+  {
+    IndexType neighbor;
+    IntersectionType type;
+  };
+
+  GridView _gridView;
+
+  std::vector<GeometryType> _cellTypes;
+  std::vector<EntitySeed> _cellSeeds;
+
+  std::vector<GlobalCoordinate> _vertices;
+  CompressedRows<IndexType,IndexType> _cellVertices;
+
+  CellFaceTable<Face> _faces;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPACTGRID_HH
@@ -0,0 +1,139 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPRESSEDROWS_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPRESSEDROWS_HH
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include <dune/geometry/typeindex.hh>
+
+#include <dune/grid/multidomaingrid/utility.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Returns the numbers of the first entities of all geometry types of the given codimension.
+/**
+ * The indices of the different geometry types are stacked on top of each other in the order of
+ * LocalGeometryTypeIndex, so the entity with type gt and index i gets the number
+ * offsets[LocalGeometryTypeIndex::index(gt)] + i. The last entry holds the number of entities.
+ */
+template<typename Offset, typename IndexSet>
+std::vector<Offset> geometryTypeOffsets(const IndexSet& indexSet, int codim, int dimension)
+{
+  std::vector<Offset> offsets(LocalGeometryTypeIndex::size(dimension - codim) + 1,0);
+  for (auto gt : indexSet.types(codim))
+    offsets[LocalGeometryTypeIndex::index(gt) + 1] = indexSet.size(gt);
+  std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+  return offsets;
+}
+
+//! Rows of varying length, stored back to back in a single array.
+/**
+ * The table is built in two passes: after setupRows(), the length of every row is announced
+ * with addToRow(), and allocate() then turns the lengths into offsets and creates the entries.
+ *
+ * \tparam T       the type of the entries.
+ * \tparam Offset  the type used to store the row offsets.
+ */
+template<typename T, typename Offset = std::size_t>
+class CompressedRows
+{
+
+public:
+
+  typedef util::Span<const T> Row;
+
+  //! Starts a new layout with the given number of empty rows.
+  void setupRows(std::size_t rows)
+  {
+    _offsets.assign(rows + 1,0);
+    _data.clear();
+  }
+
+  //! Adds n entries to row i, must be called between setupRows() and allocate().
+  void addToRow(std::size_t i, std::size_t n = 1)
+  {
+    _offsets[i + 1] += n;
+  }
+
+  //! Computes the row offsets and fills all entries with value.
+  void allocate(const T& value = T())
+  {
+    std::partial_sum(_offsets.begin(),_offsets.end(),_offsets.begin());
+    _data.assign(_offsets.back(),value);
+  }
+
+  //! Releases all memory held by the table.
+  void clear()
+  {
+    _offsets.clear();
+    _data.clear();
+  }
+
+  bool empty() const
+  {
+    return _offsets.empty();
+  }
+
+  //! Returns the number of rows.
+  std::size_t rows() const
+  {
+    return _offsets.empty() ? 0 : _offsets.size() - 1;
+  }
+
+  //! Returns the length of row i.
+  std::size_t rowSize(std::size_t i) const
+  {
+    return _offsets[i + 1] - _offsets[i];
+  }
+
+  //! Returns the position of entry j of row i in the flat storage.
+  std::size_t slot(std::size_t i, std::size_t j) const
+  {
+    return _offsets[i] + j;
+  }
+
+  //! Returns the total number of entries.
+  std::size_t size() const
+  {
+    return _data.size();
+  }
+
+  Row row(std::size_t i) const
+  {
+    return Row(_data.data() + _offsets[i],_data.data() + _offsets[i + 1]);
+  }
+
+  util::Span<T> row(std::size_t i)
+  {
+    return util::Span<T>(_data.data() + _offsets[i],_data.data() + _offsets[i + 1]);
+  }
+
+  const T& operator[](std::size_t slot) const
+  {
+    return _data[slot];
+  }
+
+  T& operator[](std::size_t slot)
+  {
+    return _data[slot];
+  }
+
+private:
+
+  std::vector<Offset> _offsets;
+  std::vector<T> _data;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_COMPRESSEDROWS_HH
@@ -203,6 +203,7 @@ class EntityWrapper<0,dim,GridImp>
 
 public:
 
+  using Geometry = typename Base::Geometry;
   using LocalGeometry = typename GridImp::template Codim<0>::LocalGeometry;
   using LeafIntersectionIterator = typename GridImp::Traits::LeafIntersectionIterator;
   using LevelIntersectionIterator = typename GridImp::Traits::LevelIntersectionIterator;
@@ -215,6 +216,13 @@ public:
     return hostEntity().subEntities(codim);
   }
 
+  //! Returns the geometry of this cell, taken from the geometry cache of the grid if possible.
+  Geometry geometry() const {
+    if (const auto* cached = grid().cachedLeafGeometry(multiDomainEntity()))
+      return Geometry(typename Geometry::Implementation(*cached));
+    return Base::geometry();
+  }
+
   template<int cc>
   typename GridImp::template Codim<cc>::Entity subEntity(int i) const {
     return {EntityWrapper<cc,dim,GridImp>(&grid(),multiDomainEntity().template subEntity<cc>(i))};
@@ -0,0 +1,134 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_FACETABLE_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_FACETABLE_HH
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/geometry/typeindex.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/grid/multidomaingrid/subdomaingrid/compressedrows.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Per-face storage for the cells of a grid view, laid out in compressed row format.
+/**
+ * The rows of the table are the cells of the grid view, numbered by their index with the
+ * indices of different geometry types stacked on top of each other in the order of
+ * LocalGeometryTypeIndex. Every row contains one slot per face of the cell, which is
+ * addressed by Intersection::indexInInside().
+ *
+ * The table does not depend on the grid type, which makes it possible to store it inside of
+ * the grid.
+ *
+ * \tparam T  the data type stored for each face.
+ */
+template<typename T>
+class CellFaceTable
+{
+
+public:
+
+  using value_type = T;
+
+  //! Sets up the layout of the table for gv and fills all slots with value.
+  template<typename GV>
+  void setup(const GV& gv, const T& value = T())
+  {
+    const auto& indexSet = gv.indexSet();
+    _cellOffsets = geometryTypeOffsets<std::size_t>(indexSet,0,GV::dimension);
+    _faces.setupRows(_cellOffsets.back());
+    for (const auto& cell : elements(gv))
+      _faces.addToRow(cellIndex(indexSet,cell),cell.subEntities(1));
+    _faces.allocate(value);
+  }
+
+  //! Releases all memory held by the table.
+  void clear()
+  {
+    _cellOffsets.clear();
+    _faces.clear();
+  }
+
+  bool empty() const
+  {
+    return _faces.empty();
+  }
+
+  //! Returns the row number of the given cell.
+  template<typename IndexSet, typename Entity>
+  std::size_t cellIndex(const IndexSet& indexSet, const Entity& e) const
+  {
+    return cellIndex(e.type(),indexSet.index(e));
+  }
+
+  //! Returns the row number of the cell with the given type and index.
+  std::size_t cellIndex(const GeometryType& gt, std::size_t index) const
+  {
+    return _cellOffsets[LocalGeometryTypeIndex::index(gt)] + index;
+  }
+
+  //! Returns the number of cells in the table.
+  std::size_t cells() const
+  {
+    return _faces.rows();
+  }
+
+  //! Returns a pointer to the first slot of the given row.
+  const T* row(std::size_t cell) const
+  {
+    return _faces.row(cell).begin();
+  }
+
+  //! Returns a pointer to the first slot of the given row.
+  T* row(std::size_t cell)
+  {
+    return _faces.row(cell).begin();
+  }
+
+  //! Returns the number of faces of the given cell.
+  std::size_t faces(std::size_t cell) const
+  {
+    return _faces.rowSize(cell);
+  }
+
+  //! Returns the position of face f of the given cell in the flat storage.
+  std::size_t slot(std::size_t cell, int f) const
+  {
+    return _faces.slot(cell,f);
+  }
+
+  //! Returns the total number of slots.
+  std::size_t size() const
+  {
+    return _faces.size();
+  }
+
+  const T& operator[](std::size_t slot) const
+  {
+    return _faces[slot];
+  }
+
+  T& operator[](std::size_t slot)
+  {
+    return _faces[slot];
+  }
+
+private:
+
+  std::vector<std::size_t> _cellOffsets;
+  CompressedRows<T> _faces;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_FACETABLE_HH
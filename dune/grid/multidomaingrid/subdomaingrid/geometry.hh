@@ -1,6 +1,9 @@
 #ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_GEOMETRY_HH
 #define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_GEOMETRY_HH
 
+#include <cassert>
+#include <optional>
+
 #include <dune/grid/common/geometry.hh>
 
 namespace Dune {
@@ -9,6 +12,42 @@ namespace mdgrid {
 
 namespace subdomain {
 
+//! Precomputed data of an affine host geometry.
+/**
+ * As the Jacobian of an affine geometry is constant, it is evaluated only once when the entry is
+ * created. The entry keeps a copy of the host geometry for all queries that are not cached.
+ */
+template<typename HostGeometry>
+struct AffineGeometryCacheEntry
+{
+
+  typedef typename HostGeometry::GlobalCoordinate GlobalCoordinate;
+  typedef typename HostGeometry::Volume Volume;
+  typedef typename HostGeometry::JacobianInverseTransposed JacobianInverseTransposed;
+  typedef typename HostGeometry::JacobianTransposed JacobianTransposed;
+
+  explicit AffineGeometryCacheEntry(const HostGeometry& hostGeometry)
+    : geometry(hostGeometry)
+    , origin(hostGeometry.global(typename HostGeometry::LocalCoordinate(0)))
+    , center(hostGeometry.center())
+    , jacobianTransposed(hostGeometry.jacobianTransposed(typename HostGeometry::LocalCoordinate(0)))
+    , jacobianInverseTransposed(hostGeometry.jacobianInverseTransposed(typename HostGeometry::LocalCoordinate(0)))
+    , integrationElement(hostGeometry.integrationElement(typename HostGeometry::LocalCoordinate(0)))
+    , volume(hostGeometry.volume())
+  {
+    assert(hostGeometry.affine());
+  }
+
+  HostGeometry geometry;
+  GlobalCoordinate origin;
+  GlobalCoordinate center;
+  JacobianTransposed jacobianTransposed;
+  JacobianInverseTransposed jacobianInverseTransposed;
+  Volume integrationElement;
+  Volume volume;
+
+};
+
 template<int mydim, int coorddim, typename GridImp>
 class GeometryWrapper
 {
@@ -44,73 +83,105 @@ public:
   typedef typename HostGeometry::JacobianInverse JacobianInverse;
   typedef typename HostGeometry::Jacobian Jacobian;
 
+  typedef AffineGeometryCacheEntry<HostGeometry> CacheEntry;
+
   GeometryType type() const {
-    return _hostGeometry.type();
+    return hostGeometry().type();
   }
 
   int corners() const {
-    return _hostGeometry.corners();
+    return hostGeometry().corners();
   }
 
   bool affine() const {
-    return _hostGeometry.affine();
+    return _cacheEntry || hostGeometry().affine();
   }
 
   GlobalCoordinate corner(int i) const {
-    return _hostGeometry.corner(i);
+    return hostGeometry().corner(i);
   }
 
   GlobalCoordinate global(const LocalCoordinate& local) const {
-    return _hostGeometry.global(local);
+    if (_cacheEntry) {
+      GlobalCoordinate global = _cacheEntry->origin;
+      _cacheEntry->jacobianTransposed.umtv(local,global);
+      return global;
+    }
+    return hostGeometry().global(local);
   }
 
   LocalCoordinate local(const GlobalCoordinate& global) const {
-    return _hostGeometry.local(global);
+    if (_cacheEntry) {
+      LocalCoordinate local;
+      _cacheEntry->jacobianInverseTransposed.mtv(global - _cacheEntry->origin,local);
+      return local;
+    }
+    return hostGeometry().local(global);
   }
 
   bool checkInside(const LocalCoordinate& local) const {
-    return _hostGeometry.checkInside(local);
+    return hostGeometry().checkInside(local);
   }
 
   Volume integrationElement(const LocalCoordinate& local) const {
-    return _hostGeometry.integrationElement(local);
+    if (_cacheEntry)
+      return _cacheEntry->integrationElement;
+    return hostGeometry().integrationElement(local);
   }
 
   Volume volume() const {
-    return _hostGeometry.volume();
+    if (_cacheEntry)
+      return _cacheEntry->volume;
+    return hostGeometry().volume();
   }
 
   GlobalCoordinate center() const {
-    return _hostGeometry.center();
+    if (_cacheEntry)
+      return _cacheEntry->center;
+    return hostGeometry().center();
   }
 
   JacobianTransposed jacobianTransposed(const LocalCoordinate& local) const {
-    return _hostGeometry.jacobianTransposed(local);
+    if (_cacheEntry)
+      return _cacheEntry->jacobianTransposed;
+    return hostGeometry().jacobianTransposed(local);
   }
 
   JacobianInverseTransposed jacobianInverseTransposed(const LocalCoordinate& local) const {
-    return _hostGeometry.jacobianInverseTransposed(local);
+    if (_cacheEntry)
+      return _cacheEntry->jacobianInverseTransposed;
+    return hostGeometry().jacobianInverseTransposed(local);
   }
 
   Jacobian jacobian(const LocalCoordinate& local) const
   {
-    return _hostGeometry.jacobian(local);
+    return hostGeometry().jacobian(local);
   }
 
   JacobianInverse jacobianInverse(const LocalCoordinate& local) const
   {
-    return _hostGeometry.jacobianInverse(local);
+    return hostGeometry().jacobianInverse(local);
   }
 
 
 private:
 
-  const HostGeometry _hostGeometry;
+  const HostGeometry& hostGeometry() const {
+    return _cacheEntry ? _cacheEntry->geometry : *_hostGeometry;
+  }
+
+  std::optional<HostGeometry> _hostGeometry;
+  const CacheEntry* _cacheEntry = nullptr;
 
   GeometryWrapper(const HostGeometry& hostGeometry)
     : _hostGeometry(hostGeometry)
   {}
 
+  //! Creates a geometry backed by a cache entry, which has to outlive the geometry.
+  GeometryWrapper(const CacheEntry& cacheEntry)
+    : _cacheEntry(&cacheEntry)
+  {}
+
 };
 
 } // namespace subdomain
@@ -0,0 +1,105 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_GEOMETRYCACHE_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_GEOMETRYCACHE_HH
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <dune/grid/multidomaingrid/subdomaingrid/geometry.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/facetable.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Precomputed affine geometries of the leaf cells of a subdomain and of their faces.
+/**
+ * Cells and faces are stored in subdomain index order, using the layout of CellFaceTable.
+ * Only affine geometries are cached; the slots of all other cells and faces stay empty, and
+ * the geometry wrappers fall back to the host geometry for them.
+ *
+ * \tparam HostCellGeometry  the geometry type of the host grid cells.
+ * \tparam HostFaceGeometry  the geometry type of the host grid faces.
+ */
+template<typename HostCellGeometry, typename HostFaceGeometry>
+class GeometryCache
+{
+
+public:
+
+  typedef AffineGeometryCacheEntry<HostCellGeometry> CellEntry;
+  typedef AffineGeometryCacheEntry<HostFaceGeometry> FaceEntry;
+
+  //! Sets up empty slots for all cells of gv and their faces.
+  template<typename GV>
+  void setup(const GV& gv)
+  {
+    _faces.setup(gv);
+    _cells.assign(_faces.cells(),std::nullopt);
+  }
+
+  //! Releases all cached geometries.
+  void clear()
+  {
+    _faces.clear();
+    _cells.clear();
+  }
+
+  bool empty() const
+  {
+    return _faces.empty();
+  }
+
+  template<typename IndexSet, typename Entity>
+  std::size_t cellIndex(const IndexSet& indexSet, const Entity& e) const
+  {
+    return _faces.cellIndex(indexSet,e);
+  }
+
+  std::size_t cellIndex(const GeometryType& gt, std::size_t index) const
+  {
+    return _faces.cellIndex(gt,index);
+  }
+
+  //! Stores the geometry of the given cell if it is affine.
+  void setCell(std::size_t cell, const HostCellGeometry& geometry)
+  {
+    if (geometry.affine())
+      _cells[cell].emplace(geometry);
+  }
+
+  //! Stores the geometry of face f of the given cell if it is affine.
+  void setFace(std::size_t cell, int f, const HostFaceGeometry& geometry)
+  {
+    if (geometry.affine())
+      _faces[_faces.slot(cell,f)].emplace(geometry);
+  }
+
+  //! Returns the cached geometry of the given cell or nullptr if it is not affine.
+  const CellEntry* cell(std::size_t cell) const
+  {
+    return _cells[cell] ? &*_cells[cell] : nullptr;
+  }
+
+  //! Returns the cached geometries of all faces of the given cell, indexed by indexInInside().
+  const std::optional<FaceEntry>* faces(std::size_t cell) const
+  {
+    return _faces.row(cell);
+  }
+
+private:
+
+  std::vector<std::optional<CellEntry> > _cells;
+  CellFaceTable<std::optional<FaceEntry> > _faces;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_GEOMETRYCACHE_HH
@@ -86,7 +86,9 @@ public:
       typename GridImp::MultiDomainGrid::LeafGridView::IntersectionIterator
       >(
         &this->indexSet(),
-        this->grid()._grid.leafGridView().ibegin(entity.impl().multiDomainEntity())
+        this->grid()._grid.leafGridView().ibegin(entity.impl().multiDomainEntity()),
+        this->grid().leafIntersectionTypes(entity),
+        this->grid().leafFaceGeometries(entity)
         );
   }
 
@@ -102,6 +104,12 @@ public:
         );
   }
 
+  //! Returns the adjacency tables of this view, see SubDomainGrid::leafAdjacency().
+  const typename GridImp::Adjacency& adjacency() const
+  {
+    return this->grid().leafAdjacency();
+  }
+
 };
 
 template<typename GridImp>
@@ -0,0 +1,365 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_HALO_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_HALO_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+#include <dune/geometry/multilineargeometry.hh>
+#include <dune/geometry/type.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/grid/multidomaingrid/subdomaingrid/communication.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/compressedrows.hh>
+
+#if HAVE_MPI
+#include <dune/common/parallel/mpicommunication.hh>
+#endif
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Additional layers of cells around the part of a subdomain held by a rank.
+/**
+ * The overlap or ghost layer of the host grid is the same for all subdomains. A SubDomainHalo
+ * widens it for a single subdomain only: every rank collects the interior cells of the subdomain
+ * within the given number of layers around the vertices it shares with a neighbouring rank, where
+ * each layer adds all cells touching a vertex of the previous one, and sends them to that rank.
+ * The receiving rank keeps all cells it does not hold itself as halo cells. Messages are only
+ * exchanged with ranks that share vertices of the subdomain, so ranks and subdomains without a
+ * halo do not pay for it.
+ *
+ * Local cells and halo cells share one index space: local cells are numbered as in
+ * SubDomainAdjacency::cellIndex(), which is the subdomain leaf index for grids with a single cell
+ * type, and halo cell i has the number localCells() + i. communicate() fills the halo part of
+ * data stored in this index space with the values of the owning ranks.
+ *
+ * Halo cells are not entities of the grid; they only provide their global id, owning rank and
+ * geometry. The halo is obtained through SubDomainGrid::halo() and discarded whenever the
+ * subdomain layout changes.
+ *
+ * All messages are exchanged over the private communicator of the subdomain (see
+ * CommunicationInterfaces::communicator()), so they cannot be received by the halos or the
+ * communications of other subdomains. The construction and communicate() block until the
+ * messages of all neighbouring ranks have arrived, though, so neighbouring ranks have to use the
+ * halos of several subdomains in the same order.
+ *
+ * \tparam GridImp  the SubDomainGrid.
+ */
+template<typename GridImp>
+class SubDomainHalo
+{
+
+  using Grid = std::remove_const_t<GridImp>;
+  using ctype = typename Grid::ctype;
+  using IdType = typename Grid::Traits::GlobalIdSet::IdType;
+  using IndexType = typename Grid::Traits::LeafIndexSet::IndexType;
+
+  static const int dimension = Grid::dimension;
+  static const int dimensionworld = Grid::dimensionworld;
+
+  static_assert(std::is_trivially_copyable<IdType>::value,"halo cells require trivially copyable global ids");
+
+  //! The MPI tag of all messages exchanged by the halo on the private communicator of the subdomain.
+  static const int tag = 12288;
+
+  //! Marks received cells that are already held by this rank.
+  static constexpr std::size_t noCell = std::size_t(-1);
+
+public:
+
+  typedef FieldVector<ctype,dimensionworld> GlobalCoordinate;
+  typedef MultiLinearGeometry<ctype,dimension,dimensionworld> Geometry;
+
+  //! A cell received from another rank.
+  struct Cell
+  {
+    //! The global id of the cell in the host grid.
+    IdType id;
+    //! The rank owning the cell.
+    int rank;
+    GeometryType type;
+    std::vector<GlobalCoordinate> corners;
+  };
+
+  //! Builds a halo with the given number of layers, this is what SubDomainGrid::halo() calls.
+  /**
+   * \note The construction is collective over all ranks of the host grid if the vertex interfaces
+   *       of the subdomain have not been discovered yet, see CommunicationInterfaces.
+   */
+  template<typename Adjacency>
+  SubDomainHalo(const Grid& grid, const CommunicationInterfaces<GridImp>& interfaces, const Adjacency& adjacency, int layers)
+    : _layers(layers)
+    , _localCells(adjacency.cells())
+  {
+#if HAVE_MPI
+    using Communication = std::decay_t<decltype(grid.multiDomainGrid().comm())>;
+    if constexpr (std::is_same_v<Communication,Dune::Communication<MPI_Comm> >)
+      {
+        if (grid.multiDomainGrid().comm().size() == 1 || layers <= 0)
+          return;
+        // discovering the vertex interfaces creates the private communicator
+        interfaces.template codimInterfaces<dimension>();
+        _comm = interfaces.communicator();
+        build(grid,interfaces,adjacency);
+      }
+#endif
+  }
+
+  SubDomainHalo(const SubDomainHalo&) = delete;
+  SubDomainHalo& operator=(const SubDomainHalo&) = delete;
+
+  //! Returns the number of layers.
+  int layers() const
+  {
+    return _layers;
+  }
+
+  //! Returns the number of local cells, which is also the number of the first halo cell.
+  std::size_t localCells() const
+  {
+    return _localCells;
+  }
+
+  //! Returns the number of halo cells.
+  std::size_t size() const
+  {
+    return _cells.size();
+  }
+
+  //! Returns the halo cell i.
+  const Cell& cell(std::size_t i) const
+  {
+    return _cells[i];
+  }
+
+  //! Returns the geometry of the halo cell i.
+  Geometry geometry(std::size_t i) const
+  {
+    return Geometry(_cells[i].type,_cells[i].corners);
+  }
+
+  //! Copies the values of the halo cells from their owners.
+  /**
+   * data is indexed by the numbers of the local and halo cells and must have at least
+   * localCells() + size() entries. The values of the interior cells sent to other ranks are read,
+   * the values of all halo cells are overwritten. The call is collective over the ranks that
+   * share vertices of the subdomain, and these ranks have to communicate the halos of different
+   * subdomains in the same order.
+   */
+  template<typename T>
+  void communicate(std::vector<T>& data) const
+  {
+    static_assert(std::is_trivially_copyable<T>::value,"halo communication requires trivially copyable data");
+    assert(data.size() >= _localCells + _cells.size());
+#if HAVE_MPI
+    std::vector<std::vector<T> > sendBuffers(_ranks.size());
+    std::vector<MPI_Request> requests(_ranks.size(),MPI_REQUEST_NULL);
+    for (std::size_t k = 0; k < _ranks.size(); ++k)
+      {
+        for (std::size_t c : _sendCells[k])
+          sendBuffers[k].push_back(data[c]);
+        MPI_Isend(sendBuffers[k].data(),static_cast<int>(sendBuffers[k].size() * sizeof(T)),MPI_BYTE,
+                  _ranks[k],tag,_comm,&requests[k]);
+      }
+    std::vector<T> receiveBuffer;
+    for (std::size_t k = 0; k < _ranks.size(); ++k)
+      {
+        receiveBuffer.resize(_receivedCells[k].size());
+        MPI_Recv(receiveBuffer.data(),static_cast<int>(receiveBuffer.size() * sizeof(T)),MPI_BYTE,
+                 _ranks[k],tag,_comm,MPI_STATUS_IGNORE);
+        for (std::size_t i = 0; i < receiveBuffer.size(); ++i)
+          if (_receivedCells[k][i] != noCell)
+            data[_localCells + _receivedCells[k][i]] = receiveBuffer[i];
+      }
+    MPI_Waitall(static_cast<int>(requests.size()),requests.data(),MPI_STATUSES_IGNORE);
+#endif
+  }
+
+private:
+
+#if HAVE_MPI
+
+  template<typename Adjacency>
+  void build(const Grid& grid, const CommunicationInterfaces<GridImp>& interfaces, const Adjacency& adjacency)
+  {
+    const auto gv = grid.leafGridView();
+    const auto& indexSet = gv.indexSet();
+
+    // vertices and owned cells in the numbering of the adjacency tables
+    CompressedRows<IndexType> cellVertices;
+    cellVertices.setupRows(_localCells);
+    std::vector<char> interior(_localCells,0);
+    for (const auto& cell : elements(gv))
+      {
+        const std::size_t c = adjacency.cellIndex(cell.type(),indexSet.index(cell));
+        cellVertices.addToRow(c,cell.subEntities(dimension));
+        interior[c] = cell.partitionType() == InteriorEntity;
+      }
+    cellVertices.allocate();
+    std::vector<IdType> ids;
+    ids.reserve(_localCells);
+    for (const auto& cell : elements(gv))
+      {
+        const std::size_t c = adjacency.cellIndex(cell.type(),indexSet.index(cell));
+        for (unsigned int i = 0; i < cell.subEntities(dimension); ++i)
+          cellVertices.row(c)[i] = indexSet.subIndex(cell,i,dimension);
+        ids.push_back(grid.globalIdSet().id(cell));
+      }
+    std::sort(ids.begin(),ids.end());
+
+    // the links of the shared vertices are ordered by rank
+    const auto& vertexInterfaces = interfaces.template codimInterfaces<dimension>();
+    const auto& links = vertexInterfaces.links;
+    std::vector<char> visited(adjacency.vertices(),0);
+    std::vector<char> selected(_localCells,0);
+    std::vector<std::size_t> frontier, next;
+    for (auto link = links.begin(); link != links.end(); )
+      {
+        const int rank = link->rank;
+        frontier.clear();
+        for (; link != links.end() && link->rank == rank; ++link)
+          {
+            const std::size_t v = indexSet.index(grid.entity(vertexInterfaces.seeds[link->entity]));
+            if (!visited[v])
+              {
+                visited[v] = 1;
+                frontier.push_back(v);
+              }
+          }
+        std::vector<std::size_t> cells;
+        std::vector<std::size_t> touched(frontier);
+        for (int layer = 0; layer < _layers && !frontier.empty(); ++layer)
+          {
+            next.clear();
+            for (std::size_t v : frontier)
+              for (auto c : adjacency.vertexCells(v))
+                if (interior[c] && !selected[c])
+                  {
+                    selected[c] = 1;
+                    cells.push_back(c);
+                    for (auto v : cellVertices.row(c))
+                      if (!visited[v])
+                        {
+                          visited[v] = 1;
+                          next.push_back(v);
+                          touched.push_back(v);
+                        }
+                  }
+            std::swap(frontier,next);
+          }
+        for (std::size_t v : touched)
+          visited[v] = 0;
+        for (std::size_t c : cells)
+          selected[c] = 0;
+        std::sort(cells.begin(),cells.end());
+        _ranks.push_back(rank);
+        _sendCells.push_back(std::move(cells));
+      }
+
+    // cells are sent with their id, type and corners
+    std::vector<EntitySeed> seeds(_localCells);
+    for (const auto& cell : elements(gv))
+      seeds[adjacency.cellIndex(cell.type(),indexSet.index(cell))] = cell.seed();
+    std::vector<std::vector<char> > sendBuffers(_ranks.size());
+    std::vector<MPI_Request> requests(_ranks.size(),MPI_REQUEST_NULL);
+    for (std::size_t k = 0; k < _ranks.size(); ++k)
+      {
+        auto& buffer = sendBuffers[k];
+        for (std::size_t c : _sendCells[k])
+          {
+            const auto cell = grid.entity(seeds[c]);
+            const auto geometry = cell.geometry();
+            write(buffer,grid.globalIdSet().id(cell));
+            write(buffer,cell.type());
+            write(buffer,geometry.corners());
+            for (int i = 0; i < geometry.corners(); ++i)
+              write(buffer,GlobalCoordinate(geometry.corner(i)));
+          }
+        MPI_Isend(buffer.data(),static_cast<int>(buffer.size()),MPI_BYTE,_ranks[k],tag,_comm,&requests[k]);
+      }
+
+    _receivedCells.resize(_ranks.size());
+    std::vector<char> buffer;
+    for (std::size_t k = 0; k < _ranks.size(); ++k)
+      {
+        MPI_Status status;
+        MPI_Probe(_ranks[k],tag,_comm,&status);
+        int count = 0;
+        MPI_Get_count(&status,MPI_BYTE,&count);
+        buffer.resize(count);
+        MPI_Recv(buffer.data(),count,MPI_BYTE,_ranks[k],tag,_comm,MPI_STATUS_IGNORE);
+        std::size_t position = 0;
+        while (position < buffer.size())
+          {
+            Cell cell;
+            cell.rank = _ranks[k];
+            read(buffer,position,cell.id);
+            read(buffer,position,cell.type);
+            int corners = 0;
+            read(buffer,position,corners);
+            cell.corners.resize(corners);
+            for (auto& corner : cell.corners)
+              read(buffer,position,corner);
+            if (std::binary_search(ids.begin(),ids.end(),cell.id))
+              _receivedCells[k].push_back(noCell);
+            else
+              {
+                _receivedCells[k].push_back(_cells.size());
+                _cells.push_back(std::move(cell));
+              }
+          }
+      }
+    MPI_Waitall(static_cast<int>(requests.size()),requests.data(),MPI_STATUSES_IGNORE);
+  }
+
+  using EntitySeed = typename Grid::Traits::template Codim<0>::EntitySeed;
+
+  template<typename T>
+  static void write(std::vector<char>& buffer, const T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value,"halo cells can only be sent as raw bytes");
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset,&value,sizeof(T));
+  }
+
+  template<typename T>
+  static void read(const std::vector<char>& buffer, std::size_t& position, T& value)
+  {
+    assert(position + sizeof(T) <= buffer.size());
+    std::memcpy(&value,buffer.data() + position,sizeof(T));
+    position += sizeof(T);
+  }
+
+  MPI_Comm _comm = MPI_COMM_NULL;
+
+#endif
+
+  int _layers;
+  std::size_t _localCells;
+  std::vector<Cell> _cells;
+  //! The neighbouring ranks, in ascending order.
+  std::vector<int> _ranks;
+  //! The local cells sent to each neighbouring rank.
+  std::vector<std::vector<std::size_t> > _sendCells;
+  //! The halo cell numbers of the cells received from each neighbouring rank, noCell for local cells.
+  std::vector<std::vector<std::size_t> > _receivedCells;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_HALO_HH
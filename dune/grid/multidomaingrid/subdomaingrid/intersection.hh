@@ -1,6 +1,8 @@
 #ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_INTERSECTION_HH
 #define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_INTERSECTION_HH
 
+#include <optional>
+
 #include <dune/grid/common/intersection.hh>
 
 namespace Dune {
@@ -43,14 +45,31 @@ class IntersectionWrapper {
   using GlobalCoords     = FieldVector<ctype,dimensionworld>;
   using LocalCoords      = FieldVector<ctype,dimension - 1>;
 
+  using IntersectionType  = typename GridImp::IntersectionType;
+  using GeometryCacheEntry = typename Geometry::Implementation::CacheEntry;
+
   IntersectionWrapper()
     : _indexSet(nullptr)
+    , _intersectionTypes(nullptr)
+    , _geometries(nullptr)
     , _intersectionTypeTested(false)
   {}
 
-  IntersectionWrapper(const IndexSet* indexSet, const MultiDomainIntersection& multiDomainIntersection)
+  //! Creates a new intersection.
+  /**
+   * \param intersectionTypes  optional precomputed intersection types of all faces of the inside
+   *                           cell, indexed by indexInInside().
+   * \param geometries         optional cached geometries of all faces of the inside cell,
+   *                           indexed by indexInInside().
+   */
+  IntersectionWrapper(const IndexSet* indexSet,
+                      const MultiDomainIntersection& multiDomainIntersection,
+                      const IntersectionType* intersectionTypes = nullptr,
+                      const std::optional<GeometryCacheEntry>* geometries = nullptr)
     : _indexSet(indexSet)
     , _multiDomainIntersection(multiDomainIntersection)
+    , _intersectionTypes(intersectionTypes)
+    , _geometries(geometries)
     , _intersectionTypeTested(false)
   {}
 
@@ -68,6 +87,11 @@ private:
 
   void checkIntersectionType() const {
     if (!_intersectionTypeTested) {
+      if (_intersectionTypes) {
+        _intersectionType = _intersectionTypes[_multiDomainIntersection.indexInInside()];
+        _intersectionTypeTested = true;
+        return;
+      }
       if (_multiDomainIntersection.boundary()) {
         _intersectionType = GridImp::boundary;
         _intersectionTypeTested = true;
@@ -139,6 +163,11 @@ private:
   }
 
   Geometry geometry() const {
+    if (_geometries) {
+      const auto& cached = _geometries[_multiDomainIntersection.indexInInside()];
+      if (cached)
+        return Geometry(typename Geometry::Implementation(*cached));
+    }
     return Geometry(hostIntersection().geometry());
   }
 
@@ -172,7 +201,7 @@ private:
     return _multiDomainIntersection.centerUnitOuterNormal();
   }
 
-  typename GridImp::IntersectionType intersectionType() const {
+  IntersectionType intersectionType() const {
     checkIntersectionType();
     return _intersectionType;
   }
@@ -186,8 +215,10 @@ private:
 
   const IndexSet* _indexSet;
   MultiDomainIntersection _multiDomainIntersection;
+  const IntersectionType* _intersectionTypes;
+  const std::optional<GeometryCacheEntry>* _geometries;
   mutable bool _intersectionTypeTested;
-  mutable typename GridImp::IntersectionType _intersectionType;
+  mutable IntersectionType _intersectionType;
 
 };
 
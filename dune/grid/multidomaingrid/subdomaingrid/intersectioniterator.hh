@@ -1,6 +1,9 @@
 #ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_INTERSECTIONITERATOR_HH
 #define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_INTERSECTIONITERATOR_HH
 
+#include <optional>
+#include <type_traits>
+
 #include <dune/grid/common/intersectioniterator.hh>
 
 #include "intersection.hh"
@@ -35,13 +38,23 @@ public:
 
   using Intersection            = Dune::Intersection<GridImp,IntersectionWrapper>;
 
+  using IntersectionType        = typename std::remove_const_t<GridImp>::IntersectionType;
+  using GeometryCacheEntry      = typename GridImp::Traits::template Codim<1>::Geometry::Implementation::CacheEntry;
+
   IntersectionIteratorWrapper()
     : _indexSet(nullptr)
+    , _intersectionTypes(nullptr)
+    , _geometries(nullptr)
   {}
 
-  IntersectionIteratorWrapper(const IndexSet* indexSet, const MultiDomainIntersectionIterator& multiDomainIterator)
+  IntersectionIteratorWrapper(const IndexSet* indexSet,
+                              const MultiDomainIntersectionIterator& multiDomainIterator,
+                              const IntersectionType* intersectionTypes = nullptr,
+                              const std::optional<GeometryCacheEntry>* geometries = nullptr)
     : _indexSet(indexSet)
     , _multiDomainIterator(multiDomainIterator)
+    , _intersectionTypes(intersectionTypes)
+    , _geometries(geometries)
   {}
 
   const auto& hostIntersectionIterator() const {
@@ -57,13 +70,15 @@ public:
   }
 
   Intersection dereference() const {
-    return {IntersectionWrapper(_indexSet,*_multiDomainIterator)};
+    return {IntersectionWrapper(_indexSet,*_multiDomainIterator,_intersectionTypes,_geometries)};
   }
 
 private:
 
   const IndexSet* _indexSet;
   MultiDomainIntersectionIterator _multiDomainIterator;
+  const IntersectionType* _intersectionTypes;
+  const std::optional<GeometryCacheEntry>* _geometries;
 
 };
 
@@ -0,0 +1,252 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_POINTLOCATOR_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_POINTLOCATOR_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace subdomain {
+
+//! Locates points in the leaf cells of a SubDomainGrid.
+/**
+ * SubDomainPointLocator sorts the bounding boxes of all cells of the subdomain into a uniform
+ * grid of buckets covering the bounding box of the subdomain, with about one cell per bucket.
+ * A query only has to test the cells registered with the bucket that contains the point,
+ * instead of all cells of the subdomain or all cells of the host grid.
+ *
+ * Point location is only meaningful for grids with dimension == dimensionworld.
+ *
+ * \note Point locators are obtained through SubDomainGrid::pointLocator(). They are discarded
+ *       when the subdomain layout changes or the grid is modified, so references to them must
+ *       not be held across MultiDomainGrid::updateSubDomains(), MultiDomainGrid::adapt(),
+ *       MultiDomainGrid::globalRefine() and MultiDomainGrid::loadBalance().
+ *
+ * \tparam GV  the leaf grid view of a SubDomainGrid.
+ */
+template<typename GV>
+class SubDomainPointLocator
+{
+
+public:
+
+  using GridView = GV;
+  using ctype    = typename GV::ctype;
+
+  static const int dimension      = GV::dimension;
+  static const int dimensionworld = GV::dimensionworld;
+
+  using GlobalCoordinate = FieldVector<ctype,dimensionworld>;
+  using LocalCoordinate  = FieldVector<ctype,dimension>;
+  using Entity           = typename GV::template Codim<0>::Entity;
+  using EntitySeed       = typename Entity::EntitySeed;
+  using Geometry         = typename Entity::Geometry;
+
+  //! Marks a point that does not lie in the subdomain.
+  static constexpr std::size_t notFound = std::numeric_limits<std::size_t>::max();
+
+  //! The result of a point query.
+  struct Result
+  {
+    //! The number of the cell in traversal order of the grid view or notFound.
+    std::size_t cell = notFound;
+    //! The seed of the cell containing the point.
+    EntitySeed seed;
+    //! The position of the point in local coordinates of the cell.
+    LocalCoordinate local;
+
+    bool found() const
+    {
+      return cell != notFound;
+    }
+  };
+
+  explicit SubDomainPointLocator(const GV& gv)
+    : _gridView(gv)
+  {
+    _lower = std::numeric_limits<ctype>::max();
+    _upper = std::numeric_limits<ctype>::lowest();
+
+    std::vector<std::array<GlobalCoordinate,2> > boxes;
+    boxes.reserve(gv.size(0));
+    _seeds.reserve(gv.size(0));
+    for (const auto& cell : elements(gv)) {
+      const Geometry geometry = cell.geometry();
+      std::array<GlobalCoordinate,2> box;
+      box[0] = std::numeric_limits<ctype>::max();
+      box[1] = std::numeric_limits<ctype>::lowest();
+      for (int c = 0; c < geometry.corners(); ++c) {
+        const GlobalCoordinate corner = geometry.corner(c);
+        for (int d = 0; d < dimensionworld; ++d) {
+          box[0][d] = std::min(box[0][d],corner[d]);
+          box[1][d] = std::max(box[1][d],corner[d]);
+        }
+      }
+      for (int d = 0; d < dimensionworld; ++d) {
+        _lower[d] = std::min(_lower[d],box[0][d]);
+        _upper[d] = std::max(_upper[d],box[1][d]);
+      }
+      boxes.push_back(box);
+      _seeds.push_back(cell.seed());
+      _geometries.push_back(geometry);
+    }
+
+    if (boxes.empty())
+      return;
+
+    // aim for about one cell per bucket
+    const std::size_t perAxis = std::max<std::size_t>(1,std::lround(std::pow(double(boxes.size()),1.0/dimensionworld)));
+    for (int d = 0; d < dimensionworld; ++d) {
+      _buckets[d] = perAxis;
+      _bucketWidth[d] = (_upper[d] - _lower[d]) / perAxis;
+    }
+
+    // sort the cells into all buckets overlapped by their bounding boxes
+    std::size_t totalBuckets = 1;
+    for (int d = 0; d < dimensionworld; ++d)
+      totalBuckets *= _buckets[d];
+    _bucketOffsets.assign(totalBuckets + 1,0);
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<std::size_t> position;
+      if (pass == 1) {
+        std::partial_sum(_bucketOffsets.begin(),_bucketOffsets.end(),_bucketOffsets.begin());
+        _bucketCells.resize(_bucketOffsets.back());
+        position.assign(_bucketOffsets.begin(),_bucketOffsets.end() - 1);
+      }
+      for (std::size_t cell = 0; cell < boxes.size(); ++cell) {
+        const auto lo = bucketCoordinates(boxes[cell][0]);
+        const auto hi = bucketCoordinates(boxes[cell][1]);
+        auto b = lo;
+        while (true) {
+          const std::size_t bucket = flatBucketIndex(b);
+          if (pass == 0)
+            ++_bucketOffsets[bucket + 1];
+          else
+            _bucketCells[position[bucket]++] = cell;
+          // advance multi-index b through the box [lo,hi]
+          int d = 0;
+          for (; d < dimensionworld; ++d) {
+            if (b[d] < hi[d]) {
+              ++b[d];
+              break;
+            }
+            b[d] = lo[d];
+          }
+          if (d == dimensionworld)
+            break;
+        }
+      }
+    }
+  }
+
+  const GridView& gridView() const
+  {
+    return _gridView;
+  }
+
+  //! Returns the number of cells of the subdomain.
+  std::size_t size() const
+  {
+    return _seeds.size();
+  }
+
+  //! Finds the cell of the subdomain that contains x.
+  /**
+   * If x lies on the boundary between multiple cells, any of them may be returned.
+   */
+  Result locate(const GlobalCoordinate& x) const
+  {
+    Result result;
+    if (_bucketCells.empty())
+      return result;
+    const ctype tolerance = 64 * std::numeric_limits<ctype>::epsilon() * (_upper - _lower).infinity_norm();
+    for (int d = 0; d < dimensionworld; ++d)
+      if (x[d] < _lower[d] - tolerance || x[d] > _upper[d] + tolerance)
+        return result;
+    const std::size_t bucket = flatBucketIndex(bucketCoordinates(x));
+    for (std::size_t i = _bucketOffsets[bucket]; i < _bucketOffsets[bucket+1]; ++i) {
+      const std::size_t cell = _bucketCells[i];
+      const Geometry& geometry = _geometries[cell];
+      const LocalCoordinate local = geometry.local(x);
+      if (referenceElement(geometry).checkInside(local)) {
+        result.cell = cell;
+        result.seed = _seeds[cell];
+        result.local = local;
+        return result;
+      }
+    }
+    return result;
+  }
+
+  //! Locates all points in the given range and stores the results in the same order.
+  template<typename Points>
+  void locate(const Points& points, std::vector<Result>& results) const
+  {
+    results.clear();
+    results.reserve(points.size());
+    for (const auto& x : points)
+      results.push_back(locate(x));
+  }
+
+  //! Returns the cell belonging to a successful query.
+  Entity entity(const Result& result) const
+  {
+    return _gridView.grid().entity(result.seed);
+  }
+
+private:
+
+  std::array<std::size_t,dimensionworld> bucketCoordinates(const GlobalCoordinate& x) const
+  {
+    std::array<std::size_t,dimensionworld> b;
+    for (int d = 0; d < dimensionworld; ++d) {
+      if (!(_bucketWidth[d] > 0)) {
+        b[d] = 0;
+        continue;
+      }
+      const ctype position = std::floor((x[d] - _lower[d]) / _bucketWidth[d]);
+      b[d] = position < 0 ? 0 : std::min(static_cast<std::size_t>(position),_buckets[d] - 1);
+    }
+    return b;
+  }
+
+  std::size_t flatBucketIndex(const std::array<std::size_t,dimensionworld>& b) const
+  {
+    std::size_t index = 0;
+    for (int d = dimensionworld - 1; d >= 0; --d)
+      index = index * _buckets[d] + b[d];
+    return index;
+  }
+
+  GridView _gridView;
+  std::vector<EntitySeed> _seeds;
+  std::vector<Geometry> _geometries;
+  GlobalCoordinate _lower;
+  GlobalCoordinate _upper;
+  std::array<std::size_t,dimensionworld> _buckets;
+  GlobalCoordinate _bucketWidth;
+  std::vector<std::size_t> _bucketOffsets;
+  std::vector<std::size_t> _bucketCells;
+
+};
+
+} // namespace subdomain
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_POINTLOCATOR_HH
@@ -2,7 +2,10 @@
 #define DUNE_MULTIDOMAINGRID_SUBDOMAINGRID_HH
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 
@@ -19,6 +22,13 @@
 #include <dune/grid/multidomaingrid/subdomaingrid/idsets.hh>
 #include <dune/grid/multidomaingrid/subdomaingrid/indexsets.hh>
 #include <dune/grid/multidomaingrid/subdomaingrid/gridview.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/compactgrid.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/communication.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/facetable.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/geometrycache.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/pointlocator.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/adjacency.hh>
+#include <dune/grid/multidomaingrid/subdomaingrid/halo.hh>
 
 
 namespace Dune {
@@ -248,6 +258,9 @@ class SubDomainGrid :
   template<typename>
   friend class LeafGridView;
 
+  template<typename>
+  friend class CommunicationInterfaces;
+
   typedef GridDefaultImplementation<MDGrid::dimension,
                                     MDGrid::dimensionworld,
                                     typename MDGrid::ctype,
@@ -272,6 +285,11 @@ private:
 
   typedef IdSetWrapper<const SubDomainGrid<MDGrid>, typename HostGrid::Traits::LocalIdSet> LocalIdSetImp;
 
+  typedef GeometryCache<
+    typename HostGrid::Traits::template Codim<0>::Geometry,
+    typename HostGrid::Traits::template Codim<1>::Geometry
+    > LeafGeometryCache;
+
 public:
 
   typedef SubDomainGridFamily<MDGrid> GridFamily;
@@ -285,6 +303,19 @@ public:
 
   enum IntersectionType { neighbor, foreign, boundary, processor };
 
+  //! The type of the standalone compact copy of this subdomain, see compactGrid().
+  typedef CompactSubDomainGrid<typename Traits::LeafGridView> CompactGrid;
+
+  //! The type of the point locator for this subdomain, see pointLocator().
+  typedef SubDomainPointLocator<typename Traits::LeafGridView> PointLocator;
+
+  //! The type of the adjacency tables of this subdomain, see leafAdjacency().
+  typedef SubDomainAdjacency<typename LeafIndexSetImp::IndexType,
+                             MDGrid::MDGridTraits::template Codim<1>::supported> Adjacency;
+
+  //! The type of the additional cell layers of this subdomain, see halo().
+  typedef SubDomainHalo<GridImp> Halo;
+
   using BaseT::dimension;
   using BaseT::dimensionworld;
 
@@ -555,7 +586,35 @@ public:
     return _grid.ghostSize(codim);
   }
 
+  //! Returns the communicator of this subdomain.
+  /**
+   * This is the communicator of the host grid, unless the MultiDomainGrid uses separate subdomain
+   * communicators (see MultiDomainGrid::setSubDomainCommunicators()). In that case, the returned
+   * communicator only contains the ranks that hold entities of this subdomain, and the first call
+   * after every update of the subdomain layout is collective over all processes, as it determines
+   * these ranks with MultiDomainGrid::subDomainRanks().
+   *
+   * \note The grid views of this subdomain forward their comm() to this method, and generic Dune
+   *       code like solvers or the VTK writer calls gridView.comm(). With separate communicators,
+   *       the first of these calls after an update or after setSubDomainCommunicators() creates
+   *       the communicator, so it has to be reached by all processes.
+   *
+   * \note The returned reference stays valid for the lifetime of this SubDomainGrid. After an
+   *       update of the subdomain layout, a reference obtained before still refers to the
+   *       communicator of the old layout, so comm() has to be called again to get the ranks that
+   *       currently hold the subdomain. The communicators of old layouts are freed together
+   *       with the SubDomainGrid.
+   */
   const typename Traits::Communication& comm() const {
+#if HAVE_MPI
+    if constexpr (std::is_same_v<typename Traits::Communication,Dune::Communication<MPI_Comm> >)
+      if (_grid.subDomainCommunicators()) {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        if (!_communicator)
+          _communicator = std::make_unique<SubDomainCommunicator>(_grid.comm(),_grid.subDomainRanks(_subDomain),int(_subDomain % 32768));
+        return _communicator->communication();
+      }
+#endif
     return _grid.comm();
   }
 
@@ -569,15 +628,46 @@ public:
     _grid._hostGrid.levelGridView(level).communicate(datahandle,iftype,dir);
   }
 
+  //! Communicates data on the leaf view of this subdomain.
+  /**
+   * Only entities contained in the subdomain take part in the communication, and messages are
+   * only exchanged with ranks that share some part of the subdomain. The required communication
+   * interfaces are set up during the first call for every codimension, which is collective and
+   * requires an exchange across the complete host grid interface. See CommunicationInterfaces.
+   */
   template<typename DataHandleImp, typename DataTypeImp>
   void communicate (CommDataHandleIF<DataHandleImp,DataTypeImp> &data,
                     InterfaceType iftype,
                     CommunicationDirection dir) const
   {
+    if (communicationInterfaces().communicate(data,iftype,dir))
+      return;
     DataHandleWrapper<CommDataHandleIF<DataHandleImp,DataTypeImp> > datahandle(data,*this);
     _grid._hostGrid.leafGridView().communicate(datahandle,iftype,dir);
   }
 
+  //! The result of communicateAsync().
+  template<typename DataHandleImp, typename DataTypeImp>
+  using AsyncCommunicationType = AsyncCommunication<GridImp,CommDataHandleIF<DataHandleImp,DataTypeImp> >;
+
+  //! Starts a non-blocking communication on the leaf view of this subdomain.
+  /**
+   * The data of all local entities is gathered immediately, and the received data is scattered
+   * when wait() is called on the returned object, or when it is destroyed. This allows computations
+   * on the interior of the subdomain to overlap with the exchange of its interface data. The
+   * communication uses the same interfaces as communicate(), see AsyncCommunication for details.
+   */
+  template<typename DataHandleImp, typename DataTypeImp>
+  AsyncCommunicationType<DataHandleImp,DataTypeImp>
+  communicateAsync (CommDataHandleIF<DataHandleImp,DataTypeImp> &data,
+                    InterfaceType iftype,
+                    CommunicationDirection dir) const
+  {
+    // every rank starts the asynchronous communications of this subdomain in the same order, which keeps the tags consistent
+    const int tag = asyncCommunicationTagBase + (_asyncCommunications++ % asyncCommunicationTags) * (MDGrid::dimension + 1);
+    return AsyncCommunicationType<DataHandleImp,DataTypeImp>(*this,communicationInterfaces(),data,iftype,dir,tag);
+  }
+
   size_t numBoundarySegments() const
   {
     return _grid.numBoundarySegments();
@@ -600,7 +690,111 @@ public:
       while (_levelIndexSets.size() <= static_cast<std::size_t>(maxLevel())) {
         _levelIndexSets.push_back(std::make_shared<LevelIndexSetImp>(*this,_grid.levelIndexSet(_levelIndexSets.size())));
       }
+      // and make sure we don't have too many...
+      if (_levelIndexSets.size() > static_cast<std::size_t>(maxLevel()) + 1)
+        _levelIndexSets.resize(maxLevel() + 1);
     }
+    _compactGrid.reset();
+    _pointLocator.reset();
+    _leafAdjacency.reset();
+    _halo.reset();
+    _communicationInterfaces.reset();
+#if HAVE_MPI
+    retireCommunicator();
+#endif
+    updateLeafIntersectionTypes();
+    updateLeafGeometryCache();
+  }
+
+  //! Enables or disables the cache of affine leaf geometries.
+  /**
+   * If enabled, the geometries of all affine leaf cells of this subdomain and of their faces are
+   * evaluated once and stored in subdomain index order. Entity::geometry() and
+   * Intersection::geometry() on the leaf level then return geometries that answer queries for the
+   * Jacobians, the integration element and the coordinate mappings from the cache instead of
+   * going through the host grid. The cache is rebuilt whenever the grid or the subdomain layout
+   * changes. Geometry objects obtained from the cache must not be used after such a change.
+   *
+   * For non-conforming leaf views, only the cell geometries are cached.
+   */
+  void setGeometryCaching(bool enabled) {
+    _geometryCaching = enabled;
+    // the point locator stores geometries that might refer to the old cache
+    _pointLocator.reset();
+    updateLeafGeometryCache();
+  }
+
+  //! Returns whether affine leaf geometries are cached, see setGeometryCaching().
+  bool geometryCaching() const {
+    return _geometryCaching;
+  }
+
+  //! Returns a standalone, contiguous copy of the leaf view of this subdomain.
+  /**
+   * The compact grid is built on first access and cached until the subdomain layout or the
+   * grid changes. Assembling over it avoids the per-entity subdomain lookups of the regular
+   * SubDomainGrid interface. See CompactSubDomainGrid for details.
+   */
+  const CompactGrid& compactGrid() const {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (!_compactGrid)
+      _compactGrid = std::make_unique<CompactGrid>(this->leafGridView());
+    return *_compactGrid;
+  }
+
+  //! Returns a spatial index for locating points in the leaf cells of this subdomain.
+  /**
+   * The point locator is built on first access and cached until the subdomain layout or the
+   * grid changes. See SubDomainPointLocator for details.
+   */
+  const PointLocator& pointLocator() const {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (!_pointLocator)
+      _pointLocator = std::make_unique<PointLocator>(this->leafGridView());
+    return *_pointLocator;
+  }
+
+  //! Returns the vertex-to-cell, cell-to-cell and cell-to-face tables of the leaf view.
+  /**
+   * The tables are built on first access and cached until the subdomain layout or the grid
+   * changes. See SubDomainAdjacency for details.
+   */
+  const Adjacency& leafAdjacency() const {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (!_leafAdjacency)
+      _leafAdjacency = std::make_unique<Adjacency>(this->leafGridView());
+    return *_leafAdjacency;
+  }
+
+  //! Sets the number of cell layers that halo() adds around the part of this subdomain held by a rank.
+  /**
+   * All ranks have to use the same number of layers. A value of 0, the default, disables the halo.
+   */
+  void setHaloLayers(int layers) {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _haloLayers = layers;
+    _halo.reset();
+  }
+
+  //! Returns the number of halo layers, see setHaloLayers().
+  int haloLayers() const {
+    return _haloLayers;
+  }
+
+  //! Returns the cells of this subdomain held by neighbouring ranks within haloLayers() layers.
+  /**
+   * The halo is built on first access and cached until the subdomain layout or the grid changes.
+   * Like communicate(), the first call after such a change is collective over all ranks. See
+   * SubDomainHalo for details.
+   */
+  const Halo& halo() const {
+    // both are required for building the halo and guarded separately
+    const auto& interfaces = communicationInterfaces();
+    const auto& adjacency = leafAdjacency();
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (!_halo)
+      _halo = std::make_unique<Halo>(*this,interfaces,adjacency,_haloLayers);
+    return *_halo;
   }
 
   bool operator==(const SubDomainGrid& rhs) const {
@@ -706,6 +900,62 @@ private:
   LocalIdSetImp _localIdSet;
   LeafIndexSetImp _leafIndexSet;
   std::vector<std::shared_ptr<LevelIndexSetImp> > _levelIndexSets;
+  CellFaceTable<IntersectionType> _leafIntersectionTypes;
+  bool _geometryCaching = false;
+  LeafGeometryCache _leafGeometryCache;
+  mutable std::mutex _cacheMutex;
+  mutable std::unique_ptr<CompactGrid> _compactGrid;
+  mutable std::unique_ptr<PointLocator> _pointLocator;
+  mutable std::unique_ptr<Adjacency> _leafAdjacency;
+  int _haloLayers = 0;
+  mutable std::unique_ptr<Halo> _halo;
+  mutable std::unique_ptr<CommunicationInterfaces<GridImp> > _communicationInterfaces;
+#if HAVE_MPI
+  mutable std::unique_ptr<SubDomainCommunicator> _communicator;
+  // communicators replaced after an update, kept alive for references obtained from comm()
+  std::vector<std::unique_ptr<SubDomainCommunicator> > _retiredCommunicators;
+  mutable std::once_flag _messageCommunicatorCreated;
+  mutable std::unique_ptr<DuplicateCommunicator> _messageCommunicator;
+#endif
+
+#if HAVE_MPI
+  //! Discards the communicator returned by comm(), see MultiDomainGrid::setSubDomainCommunicators().
+  void resetCommunicator() {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    retireCommunicator();
+  }
+
+  //! Replaces the communicator returned by comm() without invalidating references to it.
+  void retireCommunicator() {
+    if (_communicator)
+      _retiredCommunicators.push_back(std::move(_communicator));
+  }
+
+  //! Returns the private duplicate of the host communicator that carries the messages of this subdomain.
+  /**
+   * The first call is collective over all ranks of the MultiDomainGrid. The communicator only
+   * depends on the host grid, so it is kept across updates.
+   */
+  MPI_Comm messageCommunicator() const {
+    std::call_once(_messageCommunicatorCreated,[&](){
+        _messageCommunicator = std::make_unique<DuplicateCommunicator>(_grid.comm());
+      });
+    return *_messageCommunicator;
+  }
+#endif
+
+  //! MPI tags used by communicateAsync(), one block of dimension + 1 tags per pending communication.
+  static const int asyncCommunicationTagBase = 16384;
+  static const int asyncCommunicationTags = 1024;
+  mutable unsigned int _asyncCommunications = 0;
+
+  //! Returns the communication interfaces of the leaf view, creating them if necessary.
+  const CommunicationInterfaces<GridImp>& communicationInterfaces() const {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (!_communicationInterfaces)
+      _communicationInterfaces = std::make_unique<CommunicationInterfaces<GridImp> >(*this);
+    return *_communicationInterfaces;
+  }
 
   SubDomainGrid(MDGrid& grid, SubDomainIndex subDomain) :
     _grid(grid),
@@ -717,6 +967,74 @@ private:
     update();
   }
 
+  //! Classifies all faces of the leaf cells of this subdomain.
+  /**
+   * The table is only used if every face of a cell is covered by at most one intersection. For
+   * non-conforming leaf views, intersections fall back to classifying themselves on first use.
+   */
+  void updateLeafIntersectionTypes() {
+    _leafIntersectionTypes.clear();
+    typename Traits::LeafGridView gv = this->leafGridView();
+    CellFaceTable<IntersectionType> intersectionTypes;
+    std::vector<bool> visited;
+    intersectionTypes.setup(gv,boundary);
+    visited.assign(intersectionTypes.size(),false);
+    for (const auto& cell : elements(gv)) {
+      const std::size_t c = intersectionTypes.cellIndex(gv.indexSet(),cell);
+      for (const auto& intersection : intersections(gv,cell)) {
+        const std::size_t slot = intersectionTypes.slot(c,intersection.indexInInside());
+        if (visited[slot])
+          return;
+        visited[slot] = true;
+        intersectionTypes[slot] = intersectionType(intersection);
+      }
+    }
+    std::swap(_leafIntersectionTypes,intersectionTypes);
+  }
+
+  //! Returns the precomputed intersection types of the faces of e or nullptr if there are none.
+  const IntersectionType* leafIntersectionTypes(const typename Traits::template Codim<0>::Entity& e) const {
+    if (_leafIntersectionTypes.empty())
+      return nullptr;
+    return _leafIntersectionTypes.row(_leafIntersectionTypes.cellIndex(_leafIndexSet,e));
+  }
+
+  void updateLeafGeometryCache() {
+    _leafGeometryCache.clear();
+    if (!_geometryCaching)
+      return;
+    typename Traits::LeafGridView gv = this->leafGridView();
+    LeafGeometryCache geometryCache;
+    geometryCache.setup(gv);
+    // faces can only be cached if each of them corresponds to exactly one intersection
+    const bool conforming = !_leafIntersectionTypes.empty();
+    for (const auto& cell : elements(gv)) {
+      const std::size_t c = geometryCache.cellIndex(gv.indexSet(),cell);
+      geometryCache.setCell(c,hostEntity(cell).geometry());
+      if (conforming)
+        for (const auto& intersection : intersections(gv,cell))
+          geometryCache.setFace(c,intersection.indexInInside(),intersection.impl().hostIntersection().geometry());
+    }
+    std::swap(_leafGeometryCache,geometryCache);
+  }
+
+  //! Returns the cached geometry of the multidomain cell e or nullptr if there is none.
+  const typename LeafGeometryCache::CellEntry* cachedLeafGeometry(const typename MDGrid::Traits::template Codim<0>::Entity& e) const {
+    if (_leafGeometryCache.empty() || !e.isLeaf())
+      return nullptr;
+    const auto& indexSet = _grid.leafIndexSet();
+    if (!indexSet.contains(_subDomain,e))
+      return nullptr;
+    return _leafGeometryCache.cell(_leafGeometryCache.cellIndex(e.type(),indexSet.template index<0>(_subDomain,e)));
+  }
+
+  //! Returns the cached geometries of the faces of e or nullptr if there are none.
+  const std::optional<typename LeafGeometryCache::FaceEntry>* leafFaceGeometries(const typename Traits::template Codim<0>::Entity& e) const {
+    if (_leafGeometryCache.empty())
+      return nullptr;
+    return _leafGeometryCache.faces(_leafGeometryCache.cellIndex(_leafIndexSet,e));
+  }
+
   template<typename EntityType>
   bool containsMultiDomainEntity(const EntityType& e) const {
     if (_grid.supportLevelIndexSets())
@@ -0,0 +1,422 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAININTERFACERANGE_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAININTERFACERANGE_HH
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+namespace Dune {
+
+namespace mdgrid {
+
+//! A random access range over the faces of the interface between two subdomains.
+/**
+ * In contrast to LeafSubDomainInterfaceIterator and LevelSubDomainInterfaceIterator, which
+ * discover the interface while iterating over the host grid, a SubDomainInterfaceRange traverses
+ * the grid view once and stores a compact record for each interface face. The records are
+ * shared between copies of the range, so copying a range is cheap.
+ *
+ * A range can be split into disjoint sub-ranges with split() or subRange(). Iterating over a
+ * range does not modify any shared state, so different threads can process different
+ * sub-ranges of the same interface concurrently, e.g. in an OpenMP or TBB loop.
+ *
+ * The interface consists of all intersections whose inside cell belongs to subDomain1 and whose
+ * outside cell belongs to subDomain2, matching the iteration order of the interface iterators.
+ *
+ * Faces and iterators refer to the range they were obtained from, which must be kept alive
+ * while they are used.
+ *
+ * The interfaces of many subdomain pairs can be collected in a single traversal with collect().
+ *
+ * On a distributed grid, every rank by default collects all faces visible in its part of the
+ * grid view, so faces next to ghost or overlap cells are found on several ranks. With
+ * Ownership::unique, only interior cells are used as inside cells, and every face of the
+ * interface is collected on exactly one rank: the owner of its inside cell. If the host grid
+ * has no ghost or overlap cells, the subdomain sets of the cells behind processor boundaries
+ * are exchanged, and those faces are collected as remote faces without an outside cell, see
+ * Face::remote(). Collecting with Ownership::unique is a collective operation.
+ *
+ * \note The range stores entity seeds and thus remains valid until the grid or the subdomain
+ *       layout is modified.
+ *
+ * \tparam GV  a leaf or level grid view of a MultiDomainGrid.
+ */
+template<typename GV>
+class SubDomainInterfaceRange
+{
+
+public:
+
+  typedef GV GridView;
+  typedef typename GV::Grid Grid;
+  typedef typename Grid::SubDomainIndex SubDomainIndex;
+  typedef typename GV::template Codim<0>::Entity Entity;
+  typedef typename Entity::EntitySeed EntitySeed;
+  typedef typename GV::Intersection Intersection;
+  typedef typename GV::IndexSet::SubDomainSet SubDomainSet;
+
+  //! Selects which faces of a distributed interface are collected on each rank.
+  enum class Ownership {
+    //! All faces that can be seen from this rank, including those of ghost and overlap cells.
+    local,
+    //! Only faces whose inside cell is an interior cell, so every face is collected once.
+    unique
+  };
+
+  //! The data stored for every interface face.
+  struct FaceRecord
+  {
+    EntitySeed inside;
+    EntitySeed outside;
+    //! The position of the intersection in the intersection iteration of the inside cell.
+    unsigned int intersection;
+    int indexInInside;
+    //! The index of the face in the outside cell, -1 for remote faces.
+    int indexInOutside;
+    SubDomainIndex subDomain1;
+    SubDomainIndex subDomain2;
+    //! Whether the outside cell lives on another rank and is not available locally.
+    bool remote;
+  };
+
+  //! A lightweight handle for a single interface face.
+  class Face
+  {
+
+  public:
+
+    Face(const GridView& gridView, const FaceRecord& record)
+      : _gridView(&gridView)
+      , _record(&record)
+    {}
+
+    //! Returns the cell in the first subdomain.
+    Entity inside() const {
+      return _gridView->grid().entity(_record->inside);
+    }
+
+    //! Returns the cell in the second subdomain, which must not be a remote face.
+    Entity outside() const {
+      assert(!_record->remote);
+      return _gridView->grid().entity(_record->outside);
+    }
+
+    //! Returns whether the outside cell only exists on another rank.
+    /**
+     * Remote faces are only collected with Ownership::unique on host grids without ghost or
+     * overlap cells. Their intersection is a processor boundary intersection.
+     */
+    bool remote() const {
+      return _record->remote;
+    }
+
+    //! Looks up the intersection of the inside cell that forms this face.
+    Intersection intersection() const {
+      unsigned int n = 0;
+      for (const auto& is : intersections(*_gridView,inside()))
+        if (n++ == _record->intersection)
+          return is;
+      DUNE_THROW(InvalidStateException,"interface face not found, was the grid modified?");
+    }
+
+    int indexInInside() const {
+      return _record->indexInInside;
+    }
+
+    int indexInOutside() const {
+      return _record->indexInOutside;
+    }
+
+    SubDomainIndex subDomain1() const {
+      return _record->subDomain1;
+    }
+
+    SubDomainIndex subDomain2() const {
+      return _record->subDomain2;
+    }
+
+    const FaceRecord& record() const {
+      return *_record;
+    }
+
+  private:
+
+    const GridView* _gridView;
+    const FaceRecord* _record;
+
+  };
+
+  //! Random access iterator over the faces of a range.
+  class Iterator
+  {
+
+  public:
+
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Face value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Face* pointer;
+    typedef Face reference;
+
+    Iterator()
+      : _gridView(nullptr)
+      , _record(nullptr)
+    {}
+
+    Iterator(const GridView& gridView, const FaceRecord* record)
+      : _gridView(&gridView)
+      , _record(record)
+    {}
+
+    Face operator*() const { return Face(*_gridView,*_record); }
+    Face operator[](difference_type n) const { return Face(*_gridView,_record[n]); }
+
+    Iterator& operator++() { ++_record; return *this; }
+    Iterator operator++(int) { Iterator tmp(*this); ++_record; return tmp; }
+    Iterator& operator--() { --_record; return *this; }
+    Iterator operator--(int) { Iterator tmp(*this); --_record; return tmp; }
+    Iterator& operator+=(difference_type n) { _record += n; return *this; }
+    Iterator& operator-=(difference_type n) { _record -= n; return *this; }
+    Iterator operator+(difference_type n) const { return Iterator(*_gridView,_record + n); }
+    Iterator operator-(difference_type n) const { return Iterator(*_gridView,_record - n); }
+    difference_type operator-(const Iterator& rhs) const { return _record - rhs._record; }
+
+    bool operator==(const Iterator& rhs) const { return _record == rhs._record; }
+    bool operator!=(const Iterator& rhs) const { return _record != rhs._record; }
+    bool operator<(const Iterator& rhs) const { return _record < rhs._record; }
+    bool operator>(const Iterator& rhs) const { return _record > rhs._record; }
+    bool operator<=(const Iterator& rhs) const { return _record <= rhs._record; }
+    bool operator>=(const Iterator& rhs) const { return _record >= rhs._record; }
+
+  private:
+
+    const GridView* _gridView;
+    const FaceRecord* _record;
+
+  };
+
+  typedef Iterator iterator;
+  typedef Iterator const_iterator;
+
+  typedef std::pair<SubDomainIndex,SubDomainIndex> SubDomainPair;
+
+  //! Collects the interface between subDomain1 and subDomain2 in the grid view gv.
+  SubDomainInterfaceRange(const GV& gv, SubDomainIndex subDomain1, SubDomainIndex subDomain2, Ownership ownership = Ownership::local)
+    : SubDomainInterfaceRange(collect(gv,std::vector<SubDomainPair>(1,SubDomainPair(subDomain1,subDomain2)),ownership).front())
+  {}
+
+  //! Collects the interfaces of all given subdomain pairs in a single traversal of gv.
+  /**
+   * Returns one range per pair, in the order of pairs. The cost of the traversal does not
+   * depend on the number of pairs, and all returned ranges share the same face storage.
+   */
+  static std::vector<SubDomainInterfaceRange> collect(const GV& gv, const std::vector<SubDomainPair>& pairs, Ownership ownership = Ownership::local)
+  {
+    std::vector<std::vector<FaceRecord> > buckets(pairs.size());
+    std::vector<std::size_t> activePairs;
+    activePairs.reserve(pairs.size());
+    const auto& indexSet = gv.indexSet();
+    const bool unique = ownership == Ownership::unique;
+    RemoteSubDomains remoteSubDomains;
+    if (unique && gv.comm().size() > 1)
+      exchangeRemoteSubDomains(gv,remoteSubDomains);
+    for (const auto& cell : elements(gv)) {
+      if (unique && cell.partitionType() != InteriorEntity)
+        continue;
+      const auto& subDomains1 = indexSet.subDomains(cell);
+      activePairs.clear();
+      for (std::size_t p = 0; p < pairs.size(); ++p)
+        if (subDomains1.contains(pairs[p].first))
+          activePairs.push_back(p);
+      if (activePairs.empty())
+        continue;
+      unsigned int n = 0;
+      for (const auto& is : intersections(gv,cell)) {
+        if (is.neighbor()) {
+          const Entity outside = is.outside();
+          const auto& subDomains2 = indexSet.subDomains(outside);
+          for (std::size_t p : activePairs)
+            if (subDomains2.contains(pairs[p].second))
+              buckets[p].push_back(FaceRecord{cell.seed(),outside.seed(),n,is.indexInInside(),is.indexInOutside(),pairs[p].first,pairs[p].second,false});
+        } else if (!is.boundary() && !remoteSubDomains.empty()) {
+          // processor boundary without ghost cells, use the subdomains received for this face
+          const auto remote = remoteSubDomains.find(gv.grid().localIdSet().id(cell.template subEntity<1>(is.indexInInside())));
+          if (remote != remoteSubDomains.end())
+            for (std::size_t p : activePairs)
+              if (remote->second.contains(pairs[p].second))
+                buckets[p].push_back(FaceRecord{cell.seed(),EntitySeed(),n,is.indexInInside(),-1,pairs[p].first,pairs[p].second,true});
+        }
+        ++n;
+      }
+    }
+
+    // concatenate the buckets into a single shared storage
+    auto faces = std::make_shared<std::vector<FaceRecord> >();
+    std::size_t total = 0;
+    for (const auto& bucket : buckets)
+      total += bucket.size();
+    faces->reserve(total);
+    std::vector<SubDomainInterfaceRange> result;
+    result.reserve(pairs.size());
+    std::vector<std::size_t> offsets(1,0);
+    for (const auto& bucket : buckets) {
+      faces->insert(faces->end(),bucket.begin(),bucket.end());
+      offsets.push_back(faces->size());
+    }
+    std::shared_ptr<const std::vector<FaceRecord> > storage = std::move(faces);
+    for (std::size_t p = 0; p < pairs.size(); ++p)
+      result.push_back(SubDomainInterfaceRange(gv,storage,offsets[p],offsets[p+1]));
+    return result;
+  }
+
+  const GridView& gridView() const {
+    return _gridView;
+  }
+
+  //! Returns the number of faces in this range.
+  std::size_t size() const {
+    return _end - _begin;
+  }
+
+  bool empty() const {
+    return _begin == _end;
+  }
+
+  Iterator begin() const {
+    return Iterator(_gridView,_faces->data() + _begin);
+  }
+
+  Iterator end() const {
+    return Iterator(_gridView,_faces->data() + _end);
+  }
+
+  //! Returns face i of this range.
+  Face operator[](std::size_t i) const {
+    assert(i < size());
+    return Face(_gridView,(*_faces)[_begin + i]);
+  }
+
+  //! Returns the range of faces [first,last) of this range, sharing the face records.
+  SubDomainInterfaceRange subRange(std::size_t first, std::size_t last) const {
+    assert(first <= last && last <= size());
+    return SubDomainInterfaceRange(_gridView,_faces,_begin + first,_begin + last);
+  }
+
+  //! Splits this range into the given number of sub-ranges, whose sizes differ by at most one.
+  std::vector<SubDomainInterfaceRange> split(std::size_t blocks) const {
+    std::vector<SubDomainInterfaceRange> result;
+    if (blocks == 0)
+      return result;
+    result.reserve(blocks);
+    const std::size_t n = size();
+    for (std::size_t i = 0; i < blocks; ++i)
+      result.push_back(subRange((i * n) / blocks,((i + 1) * n) / blocks));
+    return result;
+  }
+
+private:
+
+  typedef typename Grid::LocalIdSet::IdType IdType;
+  typedef std::map<IdType,SubDomainSet> RemoteSubDomains;
+
+  //! Sends the subdomains of the interior cell next to each border face to the neighboring rank.
+  struct RemoteSubDomainsDataHandle
+    : public CommDataHandleIF<RemoteSubDomainsDataHandle,typename SubDomainSet::DataHandle::DataType>
+  {
+
+    bool contains(int dim, int codim) const
+    {
+      return codim == 1;
+    }
+
+    bool fixedSize(int dim, int codim) const
+    {
+      return SubDomainSet::DataHandle::fixedSize(dim,codim);
+    }
+
+    template<typename E>
+    std::size_t size(const E& e) const
+    {
+      return SubDomainSet::DataHandle::size(localSubDomains(e));
+    }
+
+    template<typename MessageBuffer, typename E>
+    void gather(MessageBuffer& buf, const E& e) const
+    {
+      SubDomainSet::DataHandle::gather(buf,localSubDomains(e));
+    }
+
+    template<typename MessageBuffer, typename E>
+    void scatter(MessageBuffer& buf, const E& e, std::size_t n)
+    {
+      SubDomainSet::DataHandle::scatter(buf,_remote[_gridView.grid().localIdSet().id(e)],n);
+    }
+
+    template<typename E>
+    const SubDomainSet& localSubDomains(const E& e) const
+    {
+      const auto it = _local.find(_gridView.grid().localIdSet().id(e));
+      return it != _local.end() ? it->second : _empty;
+    }
+
+    RemoteSubDomainsDataHandle(const GV& gv, const RemoteSubDomains& local, RemoteSubDomains& remote)
+      : _gridView(gv)
+      , _local(local)
+      , _remote(remote)
+    {}
+
+    const GV& _gridView;
+    const RemoteSubDomains& _local;
+    RemoteSubDomains& _remote;
+    const SubDomainSet _empty = SubDomainSet();
+
+  };
+
+  //! Collects the subdomains of the cells behind the processor boundary faces of gv.
+  /**
+   * Only processor boundaries without ghost or overlap cells take part in the exchange; faces
+   * next to ghost or overlap cells are handled with the subdomains that MultiDomainGrid already
+   * communicates for those cells. Every rank has to call this function.
+   */
+  static void exchangeRemoteSubDomains(const GV& gv, RemoteSubDomains& remote)
+  {
+    const auto& indexSet = gv.indexSet();
+    const auto& idSet = gv.grid().localIdSet();
+    RemoteSubDomains local;
+    for (const auto& cell : elements(gv,Partitions::interior))
+      for (const auto& is : intersections(gv,cell))
+        if (!is.neighbor() && !is.boundary())
+          local[idSet.id(cell.template subEntity<1>(is.indexInInside()))] = indexSet.subDomains(cell);
+    RemoteSubDomainsDataHandle dh(gv,local,remote);
+    gv.communicate(dh,InteriorBorder_InteriorBorder_Interface,ForwardCommunication);
+  }
+
+  SubDomainInterfaceRange(const GV& gv, std::shared_ptr<const std::vector<FaceRecord> > faces, std::size_t begin, std::size_t end)
+    : _gridView(gv)
+    , _faces(std::move(faces))
+    , _begin(begin)
+    , _end(end)
+  {}
+
+  GridView _gridView;
+  std::shared_ptr<const std::vector<FaceRecord> > _faces;
+  std::size_t _begin;
+  std::size_t _end;
+
+};
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAININTERFACERANGE_HH
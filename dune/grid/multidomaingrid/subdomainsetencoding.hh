@@ -0,0 +1,225 @@
+#ifndef DUNE_MULTIDOMAINGRID_SUBDOMAINSETENCODING_HH
+#define DUNE_MULTIDOMAINGRID_SUBDOMAINSETENCODING_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace Dune {
+
+namespace mdgrid {
+
+namespace util {
+
+/**
+ * Compact byte encoding of subdomain sets for communication.
+ *
+ * The subdomain indices of a set are visited in ascending order, and each one is stored as the
+ * difference to its predecessor (the first one as its own value) in a variable-length encoding
+ * with 7 bits per byte. The high bit of a byte marks that another byte of the same value follows.
+ * Neighbouring subdomains thus only take a single byte, independent of the size of the
+ * subdomain index type. The number of indices is not stored; it follows from the number of bytes.
+ */
+
+//! Returns the number of bytes of the variable-length encoding of value.
+template<typename T>
+std::size_t encodedSize(T value)
+{
+  std::size_t result = 1;
+  for (value >>= 7; value != 0; value >>= 7)
+    ++result;
+  return result;
+}
+
+//! Passes the bytes of the variable-length encoding of the unsigned value to put.
+template<typename T, typename Put>
+void encodeValue(T value, Put&& put)
+{
+  for (; value >= 0x80; value >>= 7)
+    put(static_cast<unsigned char>(value | 0x80));
+  put(static_cast<unsigned char>(value));
+}
+
+//! Decodes an unsigned value from the bytes returned by get and stores the number of consumed bytes in n.
+template<typename T, typename Get>
+T decodeValue(Get&& get, std::size_t& n)
+{
+  T value = 0;
+  unsigned char byte;
+  int shift = 0;
+  n = 0;
+  do {
+    byte = get();
+    ++n;
+    value |= T(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return value;
+}
+
+//! Returns the number of bytes required to encode the sorted subdomain indices of set.
+template<typename Set>
+std::size_t encodedSubDomainsSize(const Set& set)
+{
+  typedef std::make_unsigned_t<typename Set::SubDomainIndex> Value;
+  std::size_t result = 0;
+  Value previous = 0;
+  for (auto subDomain : set) {
+    result += encodedSize(Value(subDomain) - previous);
+    previous = subDomain;
+  }
+  return result;
+}
+
+//! Encodes the sorted subdomain indices of set and passes the resulting bytes to put.
+template<typename Set, typename Put>
+void encodeSubDomains(const Set& set, Put&& put)
+{
+  typedef std::make_unsigned_t<typename Set::SubDomainIndex> Value;
+  Value previous = 0;
+  for (auto subDomain : set) {
+    encodeValue(Value(Value(subDomain) - previous),put);
+    previous = subDomain;
+  }
+}
+
+//! Decodes the subdomain indices stored in the next n bytes returned by get and passes them to add.
+template<typename SubDomainIndex, typename Get, typename Add>
+void decodeSubDomains(std::size_t n, Get&& get, Add&& add)
+{
+  typedef std::make_unsigned_t<SubDomainIndex> Value;
+  Value previous = 0;
+  while (n > 0) {
+    std::size_t consumed = 0;
+    previous += decodeValue<Value>(get,consumed);
+    assert(consumed <= n);
+    n -= consumed;
+    add(SubDomainIndex(previous));
+  }
+}
+
+//! Packs a byte stream into items of type Item, which are written to a message buffer.
+/**
+ * This allows sending encoded subdomain sets through a data handle with an arbitrary, trivially
+ * copyable data type. The last item of a stream is padded with zero bytes by flush().
+ */
+template<typename Item, typename MessageBuffer>
+class ItemWriter
+{
+
+  static_assert(std::is_trivially_copyable<Item>::value,"items have to be trivially copyable");
+
+public:
+
+  explicit ItemWriter(MessageBuffer& buf)
+    : _buf(buf)
+  {}
+
+  void put(unsigned char byte)
+  {
+    _bytes[_pos++] = byte;
+    if (_pos == sizeof(Item))
+      flush();
+  }
+
+  //! Writes a partially filled item.
+  void flush()
+  {
+    if (_pos == 0)
+      return;
+    std::fill(_bytes.begin() + _pos,_bytes.end(),0);
+    Item item;
+    std::memcpy(&item,_bytes.data(),sizeof(Item));
+    _buf.write(item);
+    _pos = 0;
+  }
+
+private:
+
+  MessageBuffer& _buf;
+  std::array<unsigned char,sizeof(Item)> _bytes;
+  std::size_t _pos = 0;
+
+};
+
+//! Unpacks the byte stream written by ItemWriter.
+template<typename Item, typename MessageBuffer>
+class ItemReader
+{
+
+  static_assert(std::is_trivially_copyable<Item>::value,"items have to be trivially copyable");
+
+public:
+
+  explicit ItemReader(MessageBuffer& buf)
+    : _buf(buf)
+  {}
+
+  unsigned char get()
+  {
+    if (_pos == sizeof(Item)) {
+      Item item;
+      _buf.read(item);
+      std::memcpy(_bytes.data(),&item,sizeof(Item));
+      ++_items;
+      _pos = 0;
+    }
+    return _bytes[_pos++];
+  }
+
+  //! Returns the number of items read from the message buffer so far.
+  std::size_t items() const
+  {
+    return _items;
+  }
+
+private:
+
+  MessageBuffer& _buf;
+  std::array<unsigned char,sizeof(Item)> _bytes;
+  std::size_t _pos = sizeof(Item);
+  std::size_t _items = 0;
+
+};
+
+//! Returns the number of items of type Item required to send set as its encoded length followed by the encoded set.
+template<typename Item, typename Set>
+std::size_t encodedSubDomainsItems(const Set& set)
+{
+  const std::size_t bytes = encodedSubDomainsSize(set);
+  return (encodedSize(bytes) + bytes + sizeof(Item) - 1) / sizeof(Item);
+}
+
+//! Writes the encoded length of set followed by the encoded set into items of type Item.
+template<typename Item, typename MessageBuffer, typename Set>
+void writeSubDomainItems(MessageBuffer& buf, const Set& set)
+{
+  ItemWriter<Item,MessageBuffer> writer(buf);
+  auto put = [&](unsigned char byte) { writer.put(byte); };
+  encodeValue(encodedSubDomainsSize(set),put);
+  encodeSubDomains(set,put);
+  writer.flush();
+}
+
+//! Reads a set written by writeSubDomainItems(), passes its indices to add and returns the number of items read.
+template<typename Item, typename SubDomainIndex, typename MessageBuffer, typename Add>
+std::size_t readSubDomainItems(MessageBuffer& buf, Add&& add)
+{
+  ItemReader<Item,MessageBuffer> reader(buf);
+  auto get = [&]() { return reader.get(); };
+  std::size_t consumed = 0;
+  const std::size_t bytes = decodeValue<std::size_t>(get,consumed);
+  decodeSubDomains<SubDomainIndex>(bytes,get,add);
+  return reader.items();
+}
+
+} // namespace util
+
+} // namespace mdgrid
+
+} // namespace Dune
+
+#endif // DUNE_MULTIDOMAINGRID_SUBDOMAINSETENCODING_HH
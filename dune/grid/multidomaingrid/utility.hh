@@ -2,7 +2,12 @@
 #define DUNE_MULTIDOMAINGRID_UTILITY_HH
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 #include <dune/geometry/type.hh>
 #include <dune/common/iteratorfacades.hh>
 
@@ -42,6 +47,129 @@ collect_elementwise_struct<T,binary_function> collect_elementwise(T& result, bin
   return collect_elementwise_struct<T,binary_function>(result,f);
 }
 
+//! Non-owning view of a contiguous range of objects.
+template<typename T>
+class Span {
+
+public:
+
+  typedef T value_type;
+  typedef T* iterator;
+  typedef T* const_iterator;
+
+  Span()
+    : _begin(nullptr)
+    , _end(nullptr)
+  {}
+
+  Span(T* begin, T* end)
+    : _begin(begin)
+    , _end(end)
+  {}
+
+  T* begin() const {
+    return _begin;
+  }
+
+  T* end() const {
+    return _end;
+  }
+
+  std::size_t size() const {
+    return _end - _begin;
+  }
+
+  bool empty() const {
+    return _begin == _end;
+  }
+
+  T& operator[](std::size_t i) const {
+    return _begin[i];
+  }
+
+private:
+
+  T* _begin;
+  T* _end;
+
+};
+
+//! Maps a list of distinct, possibly sparse subdomain indices to their positions in the list.
+/**
+ * The map is an open addressing hash table with linear probing, whose capacity is the smallest
+ * power of two that holds twice the number of subdomains. Lookups take constant expected time,
+ * and the memory depends on the number of subdomains only, not on the magnitude of their indices.
+ *
+ * \tparam SubDomainIndex  the integral type of the subdomain indices.
+ */
+template<typename SubDomainIndex>
+class SubDomainSlotMap {
+
+public:
+
+  //! Returned by slot() for subdomains that are not in the map.
+  static constexpr std::size_t noSlot = std::numeric_limits<std::size_t>::max();
+
+  //! Maps subDomains[i] to i for all entries of the given range.
+  template<typename Range>
+  void assign(const Range& subDomains) {
+    _size = 0;
+    _shift = 63;
+    while ((std::size_t(1) << (64 - _shift)) < 2 * std::size_t(subDomains.size()))
+      --_shift;
+    _entries.assign(std::size_t(1) << (64 - _shift),Entry{SubDomainIndex(),noSlot});
+    for (const auto& subDomain : subDomains) {
+      std::size_t bucket = hash(subDomain);
+      while (_entries[bucket].slot != noSlot)
+        bucket = (bucket + 1) & mask();
+      _entries[bucket] = Entry{subDomain,_size++};
+    }
+  }
+
+  void clear() {
+    _entries.clear();
+    _size = 0;
+  }
+
+  //! Returns the position of subDomain in the list passed to assign(), or noSlot.
+  std::size_t slot(SubDomainIndex subDomain) const {
+    if (_entries.empty())
+      return noSlot;
+    for (std::size_t bucket = hash(subDomain); ; bucket = (bucket + 1) & mask()) {
+      const Entry& entry = _entries[bucket];
+      if (entry.slot == noSlot || entry.subDomain == subDomain)
+        return entry.slot;
+    }
+  }
+
+  //! Returns the number of subdomains in the map.
+  std::size_t size() const {
+    return _size;
+  }
+
+private:
+
+  struct Entry {
+    SubDomainIndex subDomain;
+    std::size_t slot;
+  };
+
+  std::size_t mask() const {
+    return _entries.size() - 1;
+  }
+
+  // Fibonacci hashing, which spreads runs of consecutive indices across the table
+  std::size_t hash(SubDomainIndex subDomain) const {
+    const std::uint64_t key = static_cast<std::make_unsigned_t<SubDomainIndex> >(subDomain);
+    return static_cast<std::size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> _shift);
+  }
+
+  std::vector<Entry> _entries;
+  std::size_t _size = 0;
+  unsigned int _shift = 63;
+
+};
+
 } // namespace util
 
 } // namespace mdgrid
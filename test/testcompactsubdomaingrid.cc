@@ -0,0 +1,281 @@
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/geometry/referenceelements.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+//! Reports a failed check and counts it in the variable errors of the enclosing function.
+#define CHECK(condition)                                                \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+      ++errors;                                                         \
+    }                                                                   \
+  } while (false)
+
+template<typename SDGrid>
+int checkIntersectionTypes(const SDGrid& sdgrid)
+{
+  int errors = 0;
+  auto gv = sdgrid.leafGridView();
+  const auto& mdis = sdgrid.multiDomainGrid().leafGridView().indexSet();
+  for (const auto& cell : elements(gv))
+    for (const auto& is : intersections(gv,cell)) {
+      const auto& mdIntersection = sdgrid.multiDomainIntersection(is);
+      typename SDGrid::IntersectionType expected = SDGrid::boundary;
+      if (mdIntersection.boundary())
+        expected = SDGrid::boundary;
+      else if (!mdIntersection.neighbor())
+        expected = SDGrid::processor;
+      else if (mdis.subDomains(mdIntersection.outside()).contains(sdgrid.domain()))
+        expected = SDGrid::neighbor;
+      else
+        expected = SDGrid::foreign;
+      CHECK(sdgrid.intersectionType(is) == expected);
+      CHECK(is.neighbor() == (expected == SDGrid::neighbor));
+      CHECK(is.boundary() == (expected == SDGrid::boundary || expected == SDGrid::foreign));
+    }
+  return errors;
+}
+
+template<typename G1, typename G2>
+int checkSameGeometry(const G1& g1, const G2& g2)
+{
+  int errors = 0;
+  const double tol = 1e-12;
+  auto local = Dune::ReferenceElements<double,G1::mydimension>::general(g1.type()).position(0,0);
+  local *= 0.7;
+  CHECK((g1.center() - g2.center()).two_norm() < tol);
+  CHECK(std::abs(g1.volume() - g2.volume()) < tol);
+  CHECK(std::abs(g1.integrationElement(local) - g2.integrationElement(local)) < tol);
+  auto global = g1.global(local);
+  CHECK((global - g2.global(local)).two_norm() < tol);
+  CHECK((g1.local(global) - local).two_norm() < tol);
+  typename G1::GlobalCoordinate jt1(0.0), jt2(0.0);
+  g1.jacobianTransposed(local).mtv(local,jt1);
+  g2.jacobianTransposed(local).mtv(local,jt2);
+  CHECK((jt1 - jt2).two_norm() < tol);
+  typename G1::LocalCoordinate jit1(0.0), jit2(0.0);
+  g1.jacobianInverseTransposed(local).mtv(global,jit1);
+  g2.jacobianInverseTransposed(local).mtv(global,jit2);
+  CHECK((jit1 - jit2).two_norm() < tol);
+  return errors;
+}
+
+template<typename SDGrid>
+int checkGeometryCache(const SDGrid& sdgrid)
+{
+  int errors = 0;
+  CHECK(sdgrid.geometryCaching());
+  auto gv = sdgrid.leafGridView();
+  for (const auto& cell : elements(gv)) {
+    errors += checkSameGeometry(cell.geometry(),sdgrid.multiDomainEntity(cell).geometry());
+    for (const auto& is : intersections(gv,cell))
+      errors += checkSameGeometry(is.geometry(),sdgrid.multiDomainIntersection(is).geometry());
+  }
+  return errors;
+}
+
+template<typename SDGrid>
+int checkPointLocator(const SDGrid& sdgrid)
+{
+  int errors = 0;
+  const auto& locator = sdgrid.pointLocator();
+  auto gv = sdgrid.leafGridView();
+  CHECK(locator.size() == std::size_t(gv.size(0)));
+  std::vector<Dune::FieldVector<double,2> > points;
+  for (const auto& cell : elements(gv)) {
+    const auto center = cell.geometry().center();
+    const auto result = locator.locate(center);
+    CHECK(result.found());
+    CHECK(locator.entity(result) == cell);
+    CHECK((cell.geometry().global(result.local) - center).two_norm() < 1e-12);
+    points.push_back(center);
+  }
+  // this point lies outside of both subdomains
+  points.push_back({0.9,0.1});
+  std::vector<typename SDGrid::PointLocator::Result> results;
+  locator.locate(points,results);
+  CHECK(results.size() == points.size());
+  for (std::size_t i = 0; i + 1 < points.size(); ++i)
+    CHECK(results[i].found());
+  CHECK(!results.back().found());
+  return errors;
+}
+
+template<typename SDGrid>
+int checkAdjacency(const SDGrid& sdgrid)
+{
+  int errors = 0;
+  const auto& adjacency = sdgrid.leafAdjacency();
+  auto gv = sdgrid.leafGridView();
+  const auto& is = gv.indexSet();
+  CHECK(&gv.adjacency() == &adjacency);
+  CHECK(adjacency.cells() == std::size_t(gv.size(0)));
+  CHECK(adjacency.faces() == std::size_t(gv.size(1)));
+  CHECK(adjacency.vertices() == std::size_t(gv.size(2)));
+  std::size_t vertexCellEntries = 0;
+  for (std::size_t v = 0; v < adjacency.vertices(); ++v)
+    vertexCellEntries += adjacency.vertexCells(v).size();
+  CHECK(vertexCellEntries == 4 * adjacency.cells());
+  for (const auto& cell : elements(gv)) {
+    const std::size_t c = adjacency.cellIndex(cell.type(),is.index(cell));
+    CHECK(c == std::size_t(is.index(cell)));
+    const auto faces = adjacency.cellFaces(c);
+    CHECK(faces.size() == cell.subEntities(1));
+    for (std::size_t i = 0; i < faces.size(); ++i)
+      CHECK(faces[i] == is.subIndex(cell,i,1));
+    std::vector<std::size_t> neighbors;
+    for (const auto& intersection : intersections(gv,cell))
+      if (intersection.neighbor())
+        neighbors.push_back(is.index(intersection.outside()));
+    const auto row = adjacency.cellNeighbors(c);
+    CHECK(std::equal(neighbors.begin(),neighbors.end(),row.begin(),row.end()));
+    for (unsigned int i = 0; i < cell.subEntities(2); ++i) {
+      const auto cells = adjacency.vertexCells(is.subIndex(cell,i,2));
+      CHECK(std::find(cells.begin(),cells.end(),c) != cells.end());
+    }
+  }
+  return errors;
+}
+
+//! Checks the cell and vertex tables for traits without support for codimension 1.
+template<typename HostGrid>
+int checkAdjacencyWithoutFaces(HostGrid& hostgrid)
+{
+  int errors = 0;
+  typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4,Dune::mdgrid::CellAndVertexCodims> > MDGrid;
+  MDGrid mdgrid(hostgrid,true);
+  auto mdgv = mdgrid.leafGridView();
+  mdgrid.startSubDomainMarking();
+  for (const auto& cell : elements(mdgv))
+    if (cell.geometry().center()[0] < 0.5)
+      mdgrid.addToSubDomain(0,cell);
+  mdgrid.preUpdateSubDomains();
+  mdgrid.updateSubDomains();
+  mdgrid.postUpdateSubDomains();
+
+  auto gv = mdgrid.subDomain(0).leafGridView();
+  const auto& adjacency = gv.adjacency();
+  CHECK(adjacency.cells() == std::size_t(gv.size(0)));
+  CHECK(adjacency.vertices() == std::size_t(gv.size(2)));
+  for (const auto& cell : elements(gv)) {
+    const std::size_t c = adjacency.cellIndex(cell.type(),gv.indexSet().index(cell));
+    std::size_t neighbors = 0;
+    for (const auto& intersection : intersections(gv,cell))
+      if (intersection.neighbor())
+        ++neighbors;
+    CHECK(adjacency.cellNeighbors(c).size() == neighbors);
+  }
+  return errors;
+}
+
+template<typename SDGrid>
+int checkCompactGrid(const SDGrid& sdgrid)
+{
+  int errors = 0;
+  const auto& compact = sdgrid.compactGrid();
+  auto gv = sdgrid.leafGridView();
+
+  CHECK(compact.size(0) == gv.size(0));
+  CHECK(compact.size(SDGrid::dimension) == gv.size(SDGrid::dimension));
+
+  for (const auto& cell : elements(gv)) {
+    const auto c = compact.index(cell);
+    CHECK(c < compact.size(0));
+    CHECK(compact.type(c) == cell.type());
+    CHECK(compact.entity(c) == cell);
+
+    const auto geo = cell.geometry();
+    const auto cgeo = compact.geometry(c);
+    CHECK(cgeo.corners() == geo.corners());
+    for (int i = 0; i < geo.corners(); ++i)
+      CHECK((cgeo.corner(i) - geo.corner(i)).two_norm() < 1e-12);
+    CHECK(std::abs(cgeo.volume() - geo.volume()) < 1e-12);
+
+    CHECK(compact.faces(c) == static_cast<int>(cell.subEntities(1)));
+    for (const auto& is : intersections(gv,cell)) {
+      const int f = is.indexInInside();
+      CHECK(compact.intersectionType(c,f) == sdgrid.intersectionType(is));
+      if (is.neighbor()) {
+        const auto n = compact.neighbor(c,f);
+        CHECK(n == compact.index(is.outside()));
+        CHECK(compact.neighbor(n,is.indexInOutside()) == c);
+      } else {
+        CHECK(compact.neighbor(c,f) == SDGrid::CompactGrid::noNeighbor);
+        CHECK(compact.boundary(c,f) || compact.intersectionType(c,f) == SDGrid::processor);
+      }
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{8,8}};
+    HostGrid hostgrid(L,N);
+
+    typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4> > MDGrid;
+    MDGrid mdgrid(hostgrid,true);
+    MDGrid::LeafGridView mdgv = mdgrid.leafGridView();
+
+    mdgrid.startSubDomainMarking();
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      if (c[0] < 0.5)
+        mdgrid.addToSubDomain(0,cell);
+      if (c[0] > 0.25 && c[1] > 0.25)
+        mdgrid.addToSubDomain(1,cell);
+    }
+    mdgrid.preUpdateSubDomains();
+    mdgrid.updateSubDomains();
+    mdgrid.postUpdateSubDomains();
+
+    int errors = 0;
+    errors += checkIntersectionTypes(mdgrid.subDomain(0));
+    errors += checkIntersectionTypes(mdgrid.subDomain(1));
+    errors += checkCompactGrid(mdgrid.subDomain(0));
+    errors += checkCompactGrid(mdgrid.subDomain(1));
+    errors += checkPointLocator(mdgrid.subDomain(0));
+    errors += checkPointLocator(mdgrid.subDomain(1));
+    errors += checkAdjacency(mdgrid.subDomain(0));
+    errors += checkAdjacency(mdgrid.subDomain(1));
+
+    mdgrid.subDomain(0).setGeometryCaching(true);
+    errors += checkGeometryCache(mdgrid.subDomain(0));
+
+    // the compact grids and intersection types must be rebuilt after refinement
+    mdgrid.globalRefine(1);
+    errors += checkIntersectionTypes(mdgrid.subDomain(0));
+    errors += checkIntersectionTypes(mdgrid.subDomain(1));
+    errors += checkCompactGrid(mdgrid.subDomain(0));
+    errors += checkCompactGrid(mdgrid.subDomain(1));
+    errors += checkGeometryCache(mdgrid.subDomain(0));
+    errors += checkPointLocator(mdgrid.subDomain(0));
+    errors += checkPointLocator(mdgrid.subDomain(1));
+    errors += checkAdjacency(mdgrid.subDomain(0));
+    errors += checkAdjacency(mdgrid.subDomain(1));
+    CHECK(!mdgrid.subDomain(1).geometryCaching());
+
+    errors += checkAdjacencyWithoutFaces(hostgrid);
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
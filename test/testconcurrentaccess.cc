@@ -0,0 +1,81 @@
+#include "config.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+template<typename SDGrid>
+std::size_t countFaces(const SDGrid& sdgrid)
+{
+  std::size_t faces = 0;
+  auto gv = sdgrid.leafGridView();
+  for (const auto& cell : elements(gv))
+    for (const auto& is : intersections(gv,cell))
+      if (is.neighbor() && gv.indexSet().index(cell) < gv.indexSet().index(is.outside()))
+        ++faces;
+  return faces + sdgrid.compactGrid().size(0);
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{32,32}};
+    HostGrid hostgrid(L,N);
+
+    typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,8> > MDGrid;
+    MDGrid mdgrid(hostgrid,true);
+    MDGrid::LeafGridView mdgv = mdgrid.leafGridView();
+
+    const int subDomains = 8;
+    mdgrid.startSubDomainMarking();
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      mdgrid.addToSubDomain(static_cast<int>(c[0] * subDomains),cell);
+      if (c[1] > 0.5)
+        mdgrid.addToSubDomain(static_cast<int>(c[1] * subDomains),cell);
+    }
+    mdgrid.preUpdateSubDomains();
+    mdgrid.updateSubDomains();
+    mdgrid.postUpdateSubDomains();
+
+    // all SubDomainGrids are created concurrently, with several threads racing for each of them
+    const int threadCount = 4 * subDomains;
+    std::vector<std::size_t> results(threadCount);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    const MDGrid& constgrid = mdgrid;
+    for (int t = 0; t < threadCount; ++t)
+      threads.emplace_back([&,t](){
+          while (!go)
+            std::this_thread::yield();
+          results[t] = countFaces(constgrid.subDomain(t % subDomains));
+        });
+    go = true;
+    for (auto& thread : threads)
+      thread.join();
+
+    int errors = 0;
+    for (int t = 0; t < threadCount; ++t)
+      if (results[t] != countFaces(mdgrid.subDomain(t % subDomains))) {
+        std::cerr << "thread " << t << " computed inconsistent result" << std::endl;
+        ++errors;
+      }
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,109 @@
+#include "config.h"
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+template<typename GV>
+int checkPartition(const GV& gv, std::size_t chunks)
+{
+  int errors = 0;
+  Dune::mdgrid::ElementPartition<GV> partition(gv,chunks,true);
+
+  if (partition.size() != std::min<std::size_t>(chunks,gv.size(0))) {
+    std::cerr << "wrong number of chunks: " << partition.size() << std::endl;
+    ++errors;
+  }
+
+  // every element has to appear in exactly one chunk, and chunks have to be balanced
+  std::vector<int> visited(gv.size(0),0);
+  std::size_t minSize = gv.size(0), maxSize = 0;
+  for (std::size_t c = 0; c < partition.size(); ++c) {
+    minSize = std::min(minSize,partition[c].size());
+    maxSize = std::max(maxSize,partition[c].size());
+    for (const auto& seed : partition[c])
+      ++visited[gv.indexSet().index(partition.entity(seed))];
+  }
+  for (int v : visited)
+    if (v != 1)
+      ++errors;
+  if (partition.size() > 0 && maxSize - minSize > 1) {
+    std::cerr << "unbalanced chunks: " << minSize << " - " << maxSize << std::endl;
+    ++errors;
+  }
+
+  // chunks of the same color must not share vertices
+  std::size_t coloredChunks = 0;
+  for (std::size_t color = 0; color < partition.colors(); ++color) {
+    std::set<std::size_t> vertices;
+    for (std::size_t c : partition.chunksWithColor(color)) {
+      ++coloredChunks;
+      if (partition.color(c) != color)
+        ++errors;
+      std::set<std::size_t> chunkVertices;
+      for (const auto& seed : partition[c]) {
+        const auto e = partition.entity(seed);
+        for (unsigned int i = 0; i < e.subEntities(GV::dimension); ++i)
+          chunkVertices.insert(gv.indexSet().subIndex(e,i,GV::dimension));
+      }
+      for (std::size_t v : chunkVertices)
+        if (!vertices.insert(v).second) {
+          std::cerr << "chunks of color " << color << " share vertex " << v << std::endl;
+          ++errors;
+        }
+    }
+  }
+  if (coloredChunks != partition.size())
+    ++errors;
+
+  return errors;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{16,16}};
+    HostGrid hostgrid(L,N);
+
+    typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4> > MDGrid;
+    MDGrid mdgrid(hostgrid,true);
+    MDGrid::LeafGridView mdgv = mdgrid.leafGridView();
+
+    mdgrid.startSubDomainMarking();
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      if ((c - Dune::FieldVector<double,2>(0.5)).two_norm() < 0.3)
+        mdgrid.addToSubDomain(0,cell);
+      else
+        mdgrid.addToSubDomain(1,cell);
+    }
+    mdgrid.preUpdateSubDomains();
+    mdgrid.updateSubDomains();
+    mdgrid.postUpdateSubDomains();
+
+    int errors = 0;
+    for (std::size_t chunks : {1,3,8,1000}) {
+      errors += checkPartition(mdgv,chunks);
+      errors += checkPartition(mdgrid.subDomain(0).leafGridView(),chunks);
+      errors += checkPartition(mdgrid.subDomain(1).leafGridView(),chunks);
+      // empty subdomain
+      errors += checkPartition(mdgrid.subDomain(2).leafGridView(),chunks);
+    }
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
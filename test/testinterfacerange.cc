@@ -0,0 +1,246 @@
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+template<typename Grid, typename Range>
+int checkRange(const Grid& grid, const Range& range, typename Grid::SubDomainIndex subDomain1, typename Grid::SubDomainIndex subDomain2)
+{
+  int errors = 0;
+
+  // the range has to visit the same faces in the same order as the interface iterator
+  std::size_t i = 0;
+  for (auto it = grid.leafSubDomainInterfaceBegin(subDomain1,subDomain2); it != grid.leafSubDomainInterfaceEnd(subDomain1,subDomain2); ++it, ++i) {
+    if (i >= range.size()) {
+      ++errors;
+      continue;
+    }
+    const auto face = range[i];
+    if (face.inside() != it->inside() || face.outside() != it->outside() ||
+        face.indexInInside() != it->indexInInside() || face.indexInOutside() != it->indexInOutside() ||
+        face.subDomain1() != subDomain1 || face.subDomain2() != subDomain2) {
+      std::cerr << "face " << i << " of interface (" << subDomain1 << "," << subDomain2 << ") differs" << std::endl;
+      ++errors;
+    }
+    if (face.intersection().indexInInside() != face.indexInInside())
+      ++errors;
+  }
+  if (i != range.size()) {
+    std::cerr << "interface (" << subDomain1 << "," << subDomain2 << ") has " << range.size()
+              << " faces, expected " << i << std::endl;
+    ++errors;
+  }
+
+  // the sub-ranges of a split have to cover the range in order
+  for (std::size_t blocks : {1,3,7}) {
+    auto it = range.begin();
+    for (const auto& block : range.split(blocks)) {
+      if (block.size() + 1 < range.size() / blocks || block.size() > range.size() / blocks + 1)
+        ++errors;
+      for (const auto& face : block) {
+        if (&face.record() != &(*it).record())
+          ++errors;
+        ++it;
+      }
+    }
+    if (it != range.end())
+      ++errors;
+  }
+
+  return errors;
+}
+
+template<typename Grid, typename GV>
+int checkUniqueOwnership(const Grid& grid, const GV& gv, typename Grid::SubDomainIndex subDomain1, typename Grid::SubDomainIndex subDomain2)
+{
+  typedef Dune::mdgrid::SubDomainInterfaceRange<GV> Range;
+  int errors = 0;
+  Range range(gv,subDomain1,subDomain2,Range::Ownership::unique);
+
+  // every face with an interior inside cell must be collected, either locally or as a remote face
+  std::size_t expected = 0;
+  for (auto it = grid.leafSubDomainInterfaceBegin(subDomain1,subDomain2); it != grid.leafSubDomainInterfaceEnd(subDomain1,subDomain2); ++it)
+    if (it->inside().partitionType() == Dune::InteriorEntity)
+      ++expected;
+  std::size_t local = 0;
+  for (const auto& face : range) {
+    if (face.inside().partitionType() != Dune::InteriorEntity)
+      ++errors;
+    if (!face.remote())
+      ++local;
+  }
+  if (local != expected) {
+    std::cerr << "unique interface (" << subDomain1 << "," << subDomain2 << ") has " << local
+              << " local faces, expected " << expected << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+template<typename Range>
+int checkQuadratureCache(const Range& range)
+{
+  int errors = 0;
+  Dune::mdgrid::InterfaceQuadratureCache<typename Range::GridView> cache(range,3);
+  if (cache.faces() != range.size())
+    ++errors;
+  for (std::size_t f = 0; f < cache.faces(); ++f) {
+    const auto face = range[f];
+    const auto insideGeometry = face.inside().geometry();
+    const auto outsideGeometry = face.outside().geometry();
+    double area = 0;
+    for (double w : cache.weights(f))
+      area += w;
+    if (std::abs(area - face.intersection().geometry().volume()) > 1e-12)
+      ++errors;
+    for (std::size_t q = 0; q < cache.positions(f).size(); ++q) {
+      const auto x = cache.positions(f)[q];
+      if ((insideGeometry.global(cache.insidePositions(f)[q]) - x).two_norm() > 1e-12 ||
+          (outsideGeometry.global(cache.outsidePositions(f)[q]) - x).two_norm() > 1e-12)
+        ++errors;
+      if (cache.unitOuterNormals(f)[q] * (outsideGeometry.center() - insideGeometry.center()) <= 0)
+        ++errors;
+    }
+  }
+  if (errors > 0)
+    std::cerr << "quadrature cache mismatch" << std::endl;
+  return errors;
+}
+
+template<typename Grid, int codim>
+int checkSharedEntities(const Grid& grid, Dune::Codim<codim> cd)
+{
+  int errors = 0;
+  auto gv = grid.leafGridView();
+  const auto& is = gv.indexSet();
+  std::map<std::pair<int,int>,std::size_t> counts;
+  for (const auto& e : entities(gv,cd)) {
+    const auto& subDomains = is.subDomains(e);
+    for (int a = 0; a < 4; ++a)
+      for (int b = a + 1; b < 4; ++b)
+        if (subDomains.contains(a) && subDomains.contains(b))
+          ++counts[std::make_pair(a,b)];
+  }
+  for (int a = 0; a < 4; ++a)
+    for (int b = 0; b < 4; ++b)
+      if (a != b && grid.sharedEntities(a,b,codim) != counts[std::minmax(a,b)]) {
+        std::cerr << "wrong number of shared entities of codim " << codim << " between "
+                  << a << " and " << b << std::endl;
+        ++errors;
+      }
+  for (const auto& edge : grid.subDomainGraph())
+    if (edge.subDomain1 >= edge.subDomain2 || edge.sharedEntities[codim] != counts[std::make_pair(int(edge.subDomain1),int(edge.subDomain2))])
+      ++errors;
+  return errors;
+}
+
+template<typename Grid, typename GV>
+int checkInterfaceMapper(const Grid& grid, const GV& gv, typename Grid::SubDomainIndex subDomain1, typename Grid::SubDomainIndex subDomain2)
+{
+  int errors = 0;
+  for (int codim = 1; codim <= GV::dimension; ++codim) {
+    Dune::mdgrid::InterfaceMCMGMapper<GV> mapper(gv,subDomain1,subDomain2,[codim](Dune::GeometryType gt, int dim) {
+        return int(gt.dim()) == dim - codim;
+      });
+    if (mapper.size() != grid.sharedEntities(subDomain1,subDomain2,codim)) {
+      std::cerr << "interface mapper (" << subDomain1 << "," << subDomain2 << ") has wrong size for codim "
+                << codim << std::endl;
+      ++errors;
+    }
+    // on a single process, the global numbering is the local one
+    if (mapper.globalSize() != mapper.size())
+      ++errors;
+    std::vector<bool> seen(mapper.size(),false);
+    for (const auto& cell : elements(gv))
+      for (unsigned int i = 0; i < cell.subEntities(codim); ++i) {
+        typename Dune::mdgrid::InterfaceMCMGMapper<GV>::IndexType index;
+        if (mapper.contains(cell,i,codim,index)) {
+          if (index >= mapper.size() || mapper.globalSubIndex(cell,i,codim) != index)
+            ++errors;
+          else
+            seen[index] = true;
+        }
+      }
+    if (std::find(seen.begin(),seen.end(),false) != seen.end())
+      ++errors;
+    // all faces of the interface have to be numbered
+    if (codim == 1)
+      for (auto it = grid.leafSubDomainInterfaceBegin(subDomain1,subDomain2); it != grid.leafSubDomainInterfaceEnd(subDomain1,subDomain2); ++it) {
+        typename Dune::mdgrid::InterfaceMCMGMapper<GV>::IndexType index;
+        if (!mapper.contains(it->inside(),it->indexInInside(),1,index))
+          ++errors;
+      }
+  }
+  return errors;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{16,16}};
+    HostGrid hostgrid(L,N);
+
+    typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4> > MDGrid;
+    MDGrid mdgrid(hostgrid,true);
+    typedef MDGrid::LeafGridView GV;
+    GV mdgv = mdgrid.leafGridView();
+
+    mdgrid.startSubDomainMarking();
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      if ((c - Dune::FieldVector<double,2>(0.5)).two_norm() < 0.3)
+        mdgrid.addToSubDomain(0,cell);
+      else
+        mdgrid.addToSubDomain(1,cell);
+      if (c[0] < 0.5)
+        mdgrid.addToSubDomain(2,cell);
+    }
+    mdgrid.preUpdateSubDomains();
+    mdgrid.updateSubDomains();
+    mdgrid.postUpdateSubDomains();
+
+    int errors = 0;
+    for (int a = 0; a < 4; ++a)
+      for (int b = 0; b < 4; ++b)
+        if (a != b) {
+          Dune::mdgrid::SubDomainInterfaceRange<GV> range(mdgv,a,b);
+          errors += checkRange(mdgrid,range,a,b);
+          errors += checkQuadratureCache(range);
+          errors += checkUniqueOwnership(mdgrid,mdgv,a,b);
+          errors += checkInterfaceMapper(mdgrid,mdgv,a,b);
+        }
+
+    errors += checkSharedEntities(mdgrid,Dune::Codim<0>());
+    errors += checkSharedEntities(mdgrid,Dune::Codim<1>());
+    errors += checkSharedEntities(mdgrid,Dune::Codim<2>());
+
+    // collecting many pairs at once must yield the same interfaces
+    typedef Dune::mdgrid::SubDomainInterfaceRange<GV> Range;
+    std::vector<Range::SubDomainPair> pairs = {{0,1},{1,0},{0,2},{2,1},{1,3},{0,1}};
+    auto ranges = Range::collect(mdgv,pairs);
+    if (ranges.size() != pairs.size())
+      ++errors;
+    for (std::size_t p = 0; p < ranges.size(); ++p)
+      errors += checkRange(mdgrid,ranges[p],pairs[p].first,pairs[p].second);
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
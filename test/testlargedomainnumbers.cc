@@ -1,6 +1,7 @@
 #include "config.h"
 
 #include <cstdlib>
+#include <iostream>
 
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/grid/yaspgrid.hh>
@@ -9,7 +10,7 @@
 #include "output.hh"
 
 template<typename MultiDomainGridTraits>
-void run_test(MultiDomainGridTraits traits, int sdsize)
+int run_test(MultiDomainGridTraits traits, int sdsize)
 {
   typedef Dune::YaspGrid<2> GridType;
   Dune::FieldVector<double,2> L(1.0);
@@ -35,6 +36,42 @@ void run_test(MultiDomainGridTraits traits, int sdsize)
   grid.updateSubDomains();
   grid.postUpdateSubDomains();
   vtkOut(gv,"largedomainnumbers_leafGridView",grid.leafSubDomainInterfaceBegin(0,1),grid.leafSubDomainInterfaceEnd(0,1));
+
+  // the mapper only keeps offsets for the subdomains in use
+  int errors = 0;
+  if (grid.activeSubDomains().size() != std::size_t(sd + 1)) {
+    std::cerr << "wrong number of active subdomains: " << grid.activeSubDomains().size() << std::endl;
+    ++errors;
+  }
+  Dune::MultiDomainMCMGMapper<GridView> mapper(gv,Dune::mcmgElementLayout());
+  for (typename Grid::SubDomainIndex subDomain : grid.activeSubDomains()) {
+    std::size_t size = 0;
+    for (int codim = 0; codim <= 2; ++codim)
+      size += gv.indexSet().size(subDomain,codim);
+    if (std::size_t(mapper.size(subDomain)) != size)
+      ++errors;
+  }
+  if (mapper.size(sd + 1) != 0)
+    ++errors;
+  // an inactive subdomain contains no entities, even for an index far beyond the active ones
+  typename Dune::MultiDomainMCMGMapper<GridView>::IndexType index;
+  if (mapper.contains(sd + 1,*elements(gv).begin(),index) || mapper.size(sd + 1000) != 0) {
+    std::cerr << "an inactive subdomain contains entities" << std::endl;
+    ++errors;
+  }
+  for (const auto& cell : elements(gv)) {
+    const auto subDomain = *gv.indexSet().subDomains(cell).begin();
+    if (mapper.map(subDomain,cell) < 0 || mapper.map(subDomain,cell) >= mapper.size(subDomain))
+      ++errors;
+    // subentities are mapped through the precomputed subentity type tables
+    for (int codim = 0; codim <= 2; ++codim)
+      for (unsigned int i = 0; i < cell.subEntities(codim); ++i) {
+        const auto index = mapper.map(subDomain,cell,i,codim);
+        if (index < 0 || index >= mapper.size(subDomain))
+          ++errors;
+      }
+  }
+  return errors;
 }
 
 
@@ -44,8 +81,11 @@ int main(int argc, char** argv) {
 
     const int sdsize = argc > 1 ? atoi(argv[1]) : 10;
 
-    run_test(Dune::mdgrid::ArrayBasedTraits<2,1,65536>(),sdsize);
-    run_test(Dune::mdgrid::DynamicSubDomainCountTraits<2,1>(65536),sdsize);
+    int errors = 0;
+    errors += run_test(Dune::mdgrid::ArrayBasedTraits<2,1,65536>(),sdsize);
+    errors += run_test(Dune::mdgrid::DynamicSubDomainCountTraits<2,1>(65536),sdsize);
+    if (errors > 0)
+      return 1;
 
   } catch (Dune::Exception& e) {
     std::cout << e << std::endl;
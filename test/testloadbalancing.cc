@@ -0,0 +1,92 @@
+#include "config.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{32,32}};
+    HostGrid hostgrid(L,N);
+
+    typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4> > MDGrid;
+    MDGrid mdgrid(hostgrid,true);
+    typedef MDGrid::LeafGridView GV;
+    GV mdgv = mdgrid.leafGridView();
+
+    // an expensive subdomain in the lower left corner that overlaps a cheap one
+    mdgrid.startSubDomainMarking();
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      if (c[0] < 0.25 && c[1] < 0.5)
+        mdgrid.addToSubDomain(1,cell);
+      if (c[0] > 0.125)
+        mdgrid.addToSubDomain(0,cell);
+    }
+    mdgrid.preUpdateSubDomains();
+    mdgrid.updateSubDomains();
+    mdgrid.postUpdateSubDomains();
+
+    int errors = 0;
+    const std::vector<double> cost = {1.0,20.0};
+
+    // cells in several subdomains are weighted with the sum of their costs
+    std::vector<Dune::FieldVector<double,2> > centers;
+    std::vector<double> weights;
+    for (const auto& cell : elements(mdgv)) {
+      centers.push_back(cell.geometry().center());
+      weights.push_back(Dune::mdgrid::subDomainWeight(cost,mdgv.indexSet().subDomains(cell)));
+      const auto& subDomains = mdgv.indexSet().subDomains(cell);
+      if (subDomains.contains(0) && subDomains.contains(1) && weights.back() != 21.0)
+        ++errors;
+    }
+
+    // the bisection has to balance the weights up to the weight of a single row of cells
+    for (int parts : {2,3,4,8}) {
+      const auto part = Dune::mdgrid::recursiveCoordinateBisection(mdgv.comm(),centers,weights,parts);
+      std::vector<double> partWeights(parts,0.0);
+      for (std::size_t i = 0; i < part.size(); ++i)
+        partWeights[part[i]] += weights[i];
+      double total = 0.0;
+      for (double w : weights)
+        total += w;
+      const auto [min,max] = std::minmax_element(partWeights.begin(),partWeights.end());
+      if (*max - *min > 32 * 21.0) {
+        std::cerr << "unbalanced partition into " << parts << " parts: " << *min << " - " << *max
+                  << " (total " << total << ")" << std::endl;
+        ++errors;
+      }
+    }
+
+    // YaspGrid cannot be balanced to a given partition, so the weights must not be ignored silently
+    const auto targetRanks = mdgrid.weightedPartition(cost);
+    if (std::any_of(targetRanks.begin(),targetRanks.end(),[](int rank) { return rank != 0; }))
+      ++errors;
+    if (mdgrid.weightedLoadBalance(cost)) {
+      std::cerr << "weighted load balancing of a YaspGrid did not report failure" << std::endl;
+      ++errors;
+    }
+    for (const auto& cell : elements(mdgv)) {
+      auto c = cell.geometry().center();
+      if ((c[0] < 0.25 && c[1] < 0.5) != mdgv.indexSet().subDomains(cell).contains(1))
+        ++errors;
+    }
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
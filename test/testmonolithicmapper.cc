@@ -0,0 +1,131 @@
+#include "config.h"
+
+#include <array>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+template<typename GV>
+int checkMapper(const GV& gv, Dune::mdgrid::MonolithicBlocking blocking)
+{
+  typedef Dune::mdgrid::MonolithicMCMGMapper<GV> Mapper;
+  int errors = 0;
+  Mapper mapper(gv,[](Dune::GeometryType, int) { return true; },blocking);
+  const auto& indexSet = gv.indexSet();
+
+  std::size_t expected = 0;
+  for (auto subDomain : gv.grid().activeSubDomains())
+    expected += mapper.size(subDomain);
+  if (mapper.size() != expected) {
+    std::cerr << "mapper has size " << mapper.size() << ", expected " << expected << std::endl;
+    ++errors;
+  }
+
+  // every pair of subdomain and entity has to be mapped to a distinct index
+  typedef std::tuple<int,int,std::size_t> Key;
+  std::vector<Key> owner(mapper.size(),Key(-1,-1,0));
+  for (const auto& cell : elements(gv))
+    for (int codim = 0; codim <= GV::dimension; ++codim)
+      for (unsigned int i = 0; i < cell.subEntities(codim); ++i) {
+        const auto hostIndex = indexSet.subIndex(cell,i,codim);
+        for (auto subDomain : indexSet.subDomains(cell)) {
+          const auto index = mapper.map(subDomain,cell,i,codim);
+          if (index >= mapper.size()) {
+            ++errors;
+            continue;
+          }
+          // subentities are visited from several cells
+          const Key key(subDomain,codim,hostIndex);
+          if (std::get<0>(owner[index]) < 0)
+            owner[index] = key;
+          else if (owner[index] != key)
+            ++errors;
+          if (blocking == Dune::mdgrid::MonolithicBlocking::subDomainMajor &&
+              (index < mapper.offset(subDomain) || index >= mapper.offset(subDomain) + mapper.size(subDomain)))
+            ++errors;
+          if (codim == 0 && index != mapper.map(subDomain,cell))
+            ++errors;
+        }
+        // the indices of an interleaved entity are consecutive
+        if (blocking == Dune::mdgrid::MonolithicBlocking::interleaved && codim == 0) {
+          const auto& subDomains = indexSet.subDomains(cell);
+          const auto first = mapper.map(*subDomains.begin(),cell);
+          std::size_t n = 0;
+          for (auto subDomain : subDomains)
+            if (mapper.map(subDomain,cell) != first + n++)
+              ++errors;
+        }
+      }
+  for (const auto& key : owner)
+    if (std::get<0>(key) < 0)
+      ++errors;
+
+  if (errors > 0)
+    std::cerr << "monolithic mapper check failed for blocking " << int(blocking) << std::endl;
+  return errors;
+}
+
+// marks three overlapping subdomains with the given indices, so some cells belong to two or three subdomains
+template<typename MDGridTraits, typename HostGrid>
+int runTest(HostGrid& hostgrid, const std::array<int,3>& subDomains, int inactive)
+{
+  typedef Dune::MultiDomainGrid<HostGrid,MDGridTraits> MDGrid;
+  MDGrid mdgrid(hostgrid,true);
+  typedef typename MDGrid::LeafGridView GV;
+  GV mdgv = mdgrid.leafGridView();
+
+  mdgrid.startSubDomainMarking();
+  for (const auto& cell : elements(mdgv)) {
+    auto c = cell.geometry().center();
+    if (c[0] < 0.6)
+      mdgrid.addToSubDomain(subDomains[0],cell);
+    if (c[0] > 0.4)
+      mdgrid.addToSubDomain(subDomains[1],cell);
+    if (c[1] > 0.5)
+      mdgrid.addToSubDomain(subDomains[2],cell);
+  }
+  mdgrid.preUpdateSubDomains();
+  mdgrid.updateSubDomains();
+  mdgrid.postUpdateSubDomains();
+
+  int errors = 0;
+  errors += checkMapper(mdgv,Dune::mdgrid::MonolithicBlocking::subDomainMajor);
+  errors += checkMapper(mdgv,Dune::mdgrid::MonolithicBlocking::interleaved);
+
+  // an inactive subdomain starts behind all indices
+  Dune::mdgrid::MonolithicMCMGMapper<GV> mapper(mdgv,[](Dune::GeometryType, int) { return true; });
+  if (mapper.size(inactive) != 0 || mapper.offset(inactive) != mapper.size()) {
+    std::cerr << "inactive subdomain " << inactive << " is not empty" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper::instance(argc,argv);
+
+    typedef Dune::YaspGrid<2> HostGrid;
+    Dune::FieldVector<double,2> L(1.0);
+    std::array<int,2> N = {{8,8}};
+    HostGrid hostgrid(L,N);
+
+    int errors = 0;
+    errors += runTest<Dune::mdgrid::FewSubDomainsTraits<2,4> >(hostgrid,{{0,3,1}},2);
+    // sparse indices close to the largest one must not make the mapper allocate per possible subdomain
+    errors += runTest<Dune::mdgrid::ArrayBasedTraits<2,3,65536> >(hostgrid,{{0,65535,40000}},50000);
+
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
@@ -1,5 +1,6 @@
 #include "config.h"
 
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/grid/yaspgrid.hh>
 #include <dune/grid/io/file/gmshreader.hh>
@@ -11,6 +12,8 @@
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <iterator>
 
 #if HAVE_UG
@@ -45,7 +48,7 @@ public:
   template<typename MessageBufferImp, typename Entity>
   void gather(MessageBufferImp& buf, const Entity& e) const
   {
-    buf.write(Dune::MPIHelper::getCommunication().rank());
+    buf.write(Dune::MPIHelper::getCommunication().rank() + _shift);
   }
 
   template<typename MessageBufferImp, typename Entity>
@@ -56,25 +59,511 @@ public:
     _data[_gv.indexSet().index(e)] |= 1 << i;
   }
 
-  RankTransfer(const GV& gv, DataVector& data, int codim)
+  //! The bit of the sending rank is shifted by shift, so different communications can be told apart.
+  RankTransfer(const GV& gv, DataVector& data, int codim, int shift = 0)
     : _gv(gv)
     , _data(data)
     , _codim(codim)
+    , _shift(shift)
   {}
 
 private:
   GV _gv;
   DataVector& _data;
   const int _codim;
+  const int _shift;
 
 };
 
+// Reference implementation of a subdomain communication on top of the MultiDomainGrid.
+template<typename SDGrid, typename DataVector>
+class SubDomainRankTransfer
+  : public Dune::CommDataHandleIF<SubDomainRankTransfer<SDGrid,DataVector>,
+                                  int
+                                  >
+{
+
+public:
+
+  bool contains(int dim, int codim) const
+  {
+    return codim == _codim;
+  }
+
+  bool fixedSize(int dim, int codim) const
+  {
+    return false;
+  }
+
+  template<typename Entity>
+  std::size_t size(const Entity& e) const
+  {
+    return _sdgrid.leafGridView().indexSet().contains(_sdgrid.subDomainEntity(e)) ? 1 : 0;
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void gather(MessageBufferImp& buf, const Entity& e) const
+  {
+    if (size(e) > 0)
+      buf.write(Dune::MPIHelper::getCommunication().rank());
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void scatter(MessageBufferImp& buf, const Entity& e, std::size_t n)
+  {
+    if (n == 0)
+      return;
+    int i;
+    buf.read(i);
+    if (size(e) > 0)
+      _data[_sdgrid.leafGridView().indexSet().index(_sdgrid.subDomainEntity(e))] |= 1 << i;
+  }
+
+  SubDomainRankTransfer(const SDGrid& sdgrid, DataVector& data, int codim)
+    : _sdgrid(sdgrid)
+    , _data(data)
+    , _codim(codim)
+  {}
+
+private:
+  const SDGrid& _sdgrid;
+  DataVector& _data;
+  const int _codim;
+
+};
+
+// Checks that all copies of an entity have the same global subdomain index.
+template<typename GV>
+class GlobalIndexCheck
+  : public Dune::CommDataHandleIF<GlobalIndexCheck<GV>,
+                                  std::size_t
+                                  >
+{
+
+public:
+
+  bool contains(int dim, int codim) const
+  {
+    return codim == _codim;
+  }
+
+  bool fixedSize(int dim, int codim) const
+  {
+    return false;
+  }
+
+  template<typename Entity>
+  std::size_t size(const Entity& e) const
+  {
+    return _gv.indexSet().contains(_subDomain,e) ? 1 : 0;
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void gather(MessageBufferImp& buf, const Entity& e) const
+  {
+    if (size(e) > 0)
+      buf.write(_gv.indexSet().globalIndex(_subDomain,e));
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void scatter(MessageBufferImp& buf, const Entity& e, std::size_t n)
+  {
+    if (n == 0)
+      return;
+    std::size_t i;
+    buf.read(i);
+    if (size(e) > 0 && i != _gv.indexSet().globalIndex(_subDomain,e))
+      ++_errors;
+  }
+
+  GlobalIndexCheck(const GV& gv, typename GV::Grid::SubDomainIndex subDomain, int codim)
+    : _gv(gv)
+    , _subDomain(subDomain)
+    , _codim(codim)
+  {}
+
+  int errors() const
+  {
+    return _errors;
+  }
+
+private:
+  GV _gv;
+  const typename GV::Grid::SubDomainIndex _subDomain;
+  const int _codim;
+  int _errors = 0;
+
+};
+
+template<typename Mapper>
+class InterfaceIndexCheck
+  : public Dune::CommDataHandleIF<InterfaceIndexCheck<Mapper>,
+                                  std::size_t
+                                  >
+{
+
+public:
+
+  bool contains(int dim, int codim) const
+  {
+    return codim == _codim;
+  }
+
+  bool fixedSize(int dim, int codim) const
+  {
+    return false;
+  }
+
+  template<typename Entity>
+  std::size_t size(const Entity& e) const
+  {
+    typename Mapper::IndexType index;
+    return _mapper.contains(e,index) ? 1 : 0;
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void gather(MessageBufferImp& buf, const Entity& e) const
+  {
+    if (size(e) > 0)
+      buf.write(_mapper.globalIndex(e));
+  }
+
+  template<typename MessageBufferImp, typename Entity>
+  void scatter(MessageBufferImp& buf, const Entity& e, std::size_t n)
+  {
+    if (n == 0)
+      return;
+    std::size_t i;
+    buf.read(i);
+    if (size(e) == 0 || i != _mapper.globalIndex(e))
+      ++_errors;
+  }
+
+  InterfaceIndexCheck(const Mapper& mapper, int codim)
+    : _mapper(mapper)
+    , _codim(codim)
+  {}
+
+  int errors() const
+  {
+    return _errors;
+  }
+
+private:
+  const Mapper& _mapper;
+  const int _codim;
+  int _errors = 0;
+
+};
+
+//! Checks the numbering of InterfaceMCMGMapper across processes for the interface between subdomains 0 and 1.
+template<typename MDGV>
+void checkInterfaceMapper(const MDGV& mdgv)
+{
+  typedef Dune::mdgrid::InterfaceMCMGMapper<MDGV> Mapper;
+  const int dim = MDGV::dimension;
+  for (int codim : {1,dim})
+    {
+      // the numbering is only consistent for codimensions the host grid can communicate
+      if (codim == 1 && !Dune::Capabilities::canCommunicate<typename MDGV::Grid::HostGrid,1>::v)
+        continue;
+      Mapper mapper(mdgv,0,1,[codim](Dune::GeometryType gt, int d) {
+          return int(gt.dim()) == d - codim;
+        });
+
+      // every global index has to be used, and all copies of an entity agree on it
+      std::vector<int> hits(mapper.globalSize(),0);
+      for (const auto& cell : elements(mdgv))
+        for (unsigned int i = 0; i < cell.subEntities(codim); ++i)
+          {
+            typename Mapper::IndexType index;
+            if (!mapper.contains(cell,i,codim,index))
+              continue;
+            const auto globalIndex = mapper.globalSubIndex(cell,i,codim);
+            if (globalIndex >= mapper.globalSize())
+              DUNE_THROW(Dune::Exception,"global interface index out of range");
+            hits[globalIndex] = 1;
+          }
+      mdgv.comm().max(hits.data(),hits.size());
+      if (mapper.globalSize() == 0 || std::count(hits.begin(),hits.end(),1) != int(mapper.globalSize()))
+        DUNE_THROW(Dune::Exception,"global interface indices are not contiguous for codim " << codim);
+
+      InterfaceIndexCheck<Mapper> datahandle(mapper,codim);
+      mdgv.communicate(datahandle,Dune::All_All_Interface,Dune::ForwardCommunication);
+      if (datahandle.errors() > 0)
+        DUNE_THROW(Dune::Exception,"global interface indices differ between processes for codim " << codim);
+    }
+}
+
+template<typename MDGV>
+void checkGlobalIndices(const MDGV& mdgv)
+{
+  const int dim = MDGV::dimension;
+  const auto& indexSet = mdgv.indexSet();
+  for (auto s : mdgv.grid().activeSubDomains())
+    for (int codim : {0,dim})
+      {
+        if (!indexSet.hasGlobalIndices(codim))
+          DUNE_THROW(Dune::Exception,"no global indices for codim " << codim);
+
+        // the owned entities of all ranks have to cover the global index range exactly once
+        const std::size_t globalSize = indexSet.globalSize(s,codim);
+        std::vector<int> hits(globalSize,0);
+        for (const auto& cell : elements(mdgv))
+          for (unsigned int i = 0; i < cell.subEntities(codim); ++i)
+            {
+              std::size_t index = 0;
+              bool found = false;
+              Dune::Hybrid::forEach(std::make_integer_sequence<int,dim+1>(),[&](auto cc){
+                  if constexpr (cc == 0 || cc == dim)
+                    if (cc == codim)
+                      {
+                        const auto e = cell.template subEntity<cc>(i);
+                        found = indexSet.contains(s,e);
+                        if (found)
+                          index = indexSet.globalIndex(s,e);
+                      }
+                });
+              if (!found)
+                continue;
+              if (index >= globalSize)
+                DUNE_THROW(Dune::Exception,"global index out of range on subdomain " << s);
+              hits[index] = 1;
+            }
+        if (mdgv.comm().size() == 1 &&
+            (globalSize != std::size_t(indexSet.size(s,codim)) ||
+             std::count(hits.begin(),hits.end(),1) != int(globalSize)))
+          DUNE_THROW(Dune::Exception,"global indices differ from local indices on subdomain " << s);
+        mdgv.comm().max(hits.data(),hits.size());
+        if (std::count(hits.begin(),hits.end(),1) != int(globalSize))
+          DUNE_THROW(Dune::Exception,"global indices of subdomain " << s << " are not contiguous");
+
+        GlobalIndexCheck<MDGV> datahandle(mdgv,s,codim);
+        mdgv.communicate(datahandle,Dune::All_All_Interface,Dune::ForwardCommunication);
+        if (datahandle.errors() > 0)
+          DUNE_THROW(Dune::Exception,"global indices of subdomain " << s << " differ between processes");
+      }
+}
+
+template<typename MDGrid>
+void checkSubDomainRanks(MDGrid& grid)
+{
+  const auto& comm = grid.comm();
+  const auto& active = grid.activeSubDomains();
+  for (typename MDGrid::SubDomainIndex s = 0; s < 8; ++s)
+    {
+      const auto ranks = grid.subDomainRanks(s);
+      const bool present = std::binary_search(active.begin(),active.end(),s);
+      if (std::binary_search(ranks.begin(),ranks.end(),comm.rank()) != present)
+        DUNE_THROW(Dune::Exception,"presence map of subdomain " << s << " is wrong for this rank");
+      if (comm.sum(int(present)) != int(ranks.size()))
+        DUNE_THROW(Dune::Exception,"presence map of subdomain " << s << " has the wrong number of ranks");
+    }
+
+#if HAVE_MPI
+  // the subdomain communicators only contain the ranks of the presence map
+  grid.setSubDomainCommunicators(true);
+  for (typename MDGrid::SubDomainIndex s = 0; s < 8; ++s)
+    {
+      const auto& subDomainComm = grid.subDomain(s).comm();
+      const bool present = std::binary_search(active.begin(),active.end(),s);
+      const int expected = present ? grid.subDomainRanks(s).size() : 0;
+      if (subDomainComm.size() != expected || (present && subDomainComm.sum(1) != expected))
+        DUNE_THROW(Dune::Exception,"wrong communicator for subdomain " << s);
+    }
+  grid.setSubDomainCommunicators(false);
+#endif
+}
+
+template<typename SDGrid>
+void checkHalo(const SDGrid& sdgrid, int rank)
+{
+  typedef typename SDGrid::LeafGridView SDGV;
+  SDGV sdgv = sdgrid.leafGridView();
+  const auto& adjacency = sdgrid.leafAdjacency();
+  const auto& halo = sdgrid.halo();
+  if (halo.localCells() != adjacency.cells())
+    DUNE_THROW(Dune::Exception,"halo uses the wrong number of local cells");
+
+  // every halo cell has to receive the rank of its owner
+  std::vector<int> data(halo.localCells() + halo.size(),-1);
+  for (const auto& cell : elements(sdgv))
+    if (cell.partitionType() == Dune::InteriorEntity)
+      data[adjacency.cellIndex(cell.type(),sdgv.indexSet().index(cell))] = rank;
+  halo.communicate(data);
+  for (std::size_t i = 0; i < halo.size(); ++i)
+    {
+      if (halo.cell(i).rank == rank || data[halo.localCells() + i] != halo.cell(i).rank)
+        DUNE_THROW(Dune::Exception,"halo cell " << i << " has the wrong owner");
+      if (halo.geometry(i).volume() <= 0.0)
+        DUNE_THROW(Dune::Exception,"halo cell " << i << " has an invalid geometry");
+    }
+}
+
+// The halos of several subdomains must not receive each other's messages, even while an
+// asynchronous communication of one of the subdomains is pending.
+template<typename MDGrid>
+void checkHalos(MDGrid& grid, int rank)
+{
+  const int dim = MDGrid::dimension;
+  typedef typename MDGrid::SubDomainGrid SDGrid;
+  typedef typename SDGrid::LeafGridView SDGV;
+  auto& first = grid.subDomain(4);
+  auto& second = grid.subDomain(5);
+  const SDGV firstGV = first.leafGridView();
+  const SDGV secondGV = second.leafGridView();
+
+  // different numbers of layers give messages of different sizes
+  first.setHaloLayers(2);
+  second.setHaloLayers(3);
+  const auto& firstHalo = first.halo();
+  const auto& secondHalo = second.halo();
+
+  typedef std::vector<std::size_t> DataVector;
+  DataVector reference(firstGV.size(dim),0);
+  RankTransfer<SDGV,DataVector> referenceHandle(firstGV,reference,dim);
+  first.communicate(referenceHandle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+  DataVector asyncData(firstGV.size(dim),0);
+  RankTransfer<SDGV,DataVector> asyncHandle(firstGV,asyncData,dim);
+  auto communication = first.communicateAsync(asyncHandle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+
+  auto ownerData = [&](const SDGrid& sdgrid, const auto& halo, int offset) {
+    const SDGV sdgv = sdgrid.leafGridView();
+    const auto& adjacency = sdgrid.leafAdjacency();
+    std::vector<int> data(halo.localCells() + halo.size(),-1);
+    for (const auto& cell : elements(sdgv,Dune::Partitions::interior))
+      data[adjacency.cellIndex(cell.type(),sdgv.indexSet().index(cell))] = offset + rank;
+    return data;
+  };
+  std::vector<int> firstData = ownerData(first,firstHalo,0);
+  std::vector<int> secondData = ownerData(second,secondHalo,100);
+  // the halos are used in a different order than they were built
+  secondHalo.communicate(secondData);
+  firstHalo.communicate(firstData);
+  communication.wait();
+
+  for (std::size_t i = 0; i < firstHalo.size(); ++i)
+    if (firstData[firstHalo.localCells() + i] != firstHalo.cell(i).rank)
+      DUNE_THROW(Dune::Exception,"halo cell " << i << " of subdomain 4 received wrong data");
+  for (std::size_t i = 0; i < secondHalo.size(); ++i)
+    if (secondData[secondHalo.localCells() + i] != 100 + secondHalo.cell(i).rank)
+      DUNE_THROW(Dune::Exception,"halo cell " << i << " of subdomain 5 received wrong data");
+  if (asyncData != reference)
+    DUNE_THROW(Dune::Exception,"asynchronous communication differs from reference while halos were used");
+}
+
+//! Checks that every face of a distributed interface is collected on exactly one rank with Ownership::unique.
 template<typename HostGrid>
+void testUniqueInterfaces(HostGrid& hostgrid)
+{
+  typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,4> > MDGrid;
+  typedef typename MDGrid::LeafGridView MDGV;
+  typedef Dune::mdgrid::SubDomainInterfaceRange<MDGV> Range;
+  MDGrid grid(hostgrid,true);
+  MDGV mdgv = grid.leafGridView();
+
+  // one subdomain per quadrant of the unit square
+  grid.startSubDomainMarking();
+  for (const auto& cell : elements(mdgv,Dune::Partitions::interior))
+    {
+      const auto center = cell.geometry().center();
+      grid.addToSubDomain((center[0] > 0.5 ? 1 : 0) + (center[1] > 0.5 ? 2 : 0),cell);
+    }
+  grid.preUpdateSubDomains();
+  grid.updateSubDomains();
+  grid.postUpdateSubDomains();
+
+  const auto& comm = grid.comm();
+  const std::vector<std::pair<int,int> > pairs = {{0,1},{1,0},{0,2},{1,3},{2,3},{3,2}};
+  for (const auto& pair : pairs)
+    {
+      Range range(mdgv,pair.first,pair.second,Range::Ownership::unique);
+      std::vector<double> centers;
+      double length = 0.0;
+      for (const auto& face : range)
+        {
+          const auto geometry = face.intersection().geometry();
+          length += geometry.volume();
+          for (double x : geometry.center())
+            centers.push_back(x);
+        }
+
+      // every interface between two quadrants has length 0.5
+      if (std::abs(comm.sum(length) - 0.5) > 1e-10)
+        DUNE_THROW(Dune::Exception,"unique interface (" << pair.first << "," << pair.second << ") does not cover the interface exactly once");
+
+      int count = centers.size();
+      std::vector<int> counts(comm.size());
+      comm.allgather(&count,1,counts.data());
+      std::vector<int> displacements(comm.size() + 1,0);
+      std::partial_sum(counts.begin(),counts.end(),displacements.begin() + 1);
+      std::vector<double> all(std::max(displacements.back(),1));
+      comm.allgatherv(centers.data(),count,all.data(),counts.data(),displacements.data());
+      std::vector<std::pair<double,double> > faces;
+      for (int i = 0; i + 1 < displacements.back(); i += 2)
+        faces.emplace_back(all[i],all[i+1]);
+      std::sort(faces.begin(),faces.end());
+      for (std::size_t i = 1; i < faces.size(); ++i)
+        if (std::abs(faces[i].first - faces[i-1].first) < 1e-10 && std::abs(faces[i].second - faces[i-1].second) < 1e-10)
+          DUNE_THROW(Dune::Exception,"face of unique interface (" << pair.first << "," << pair.second << ") collected on several ranks");
+    }
+}
+
+// Pending asynchronous communications of several subdomains and of the MultiDomainGrid must not
+// receive each other's messages, whatever order they are completed in.
+template<typename MDGrid>
+void checkOverlappingAsyncCommunications(const MDGrid& grid)
+{
+  const int dim = MDGrid::dimension;
+  typedef typename MDGrid::LeafGridView MDGV;
+  typedef typename MDGrid::SubDomainGrid::LeafGridView SDGV;
+  typedef std::vector<std::size_t> DataVector;
+  const auto& first = grid.subDomain(4);
+  const auto& second = grid.subDomain(5);
+  const SDGV firstGV = first.leafGridView();
+  const SDGV secondGV = second.leafGridView();
+  const MDGV mdgv = grid.leafGridView();
+  const auto iftype = Dune::InteriorBorder_All_Interface;
+  const auto dir = Dune::ForwardCommunication;
+
+  for (int codim : {0,dim})
+    {
+      // every communication sends different values
+      DataVector firstReference(firstGV.size(codim),0);
+      DataVector secondReference(secondGV.size(codim),0);
+      DataVector gridReference(mdgv.size(codim),0);
+      RankTransfer<SDGV,DataVector> firstReferenceHandle(firstGV,firstReference,codim,0);
+      RankTransfer<SDGV,DataVector> secondReferenceHandle(secondGV,secondReference,codim,8);
+      RankTransfer<MDGV,DataVector> gridReferenceHandle(mdgv,gridReference,codim,16);
+      first.communicate(firstReferenceHandle,iftype,dir);
+      second.communicate(secondReferenceHandle,iftype,dir);
+      grid.communicate(gridReferenceHandle,iftype,dir);
+
+      DataVector firstData(firstGV.size(codim),0);
+      DataVector secondData(secondGV.size(codim),0);
+      DataVector gridData(mdgv.size(codim),0);
+      RankTransfer<SDGV,DataVector> firstHandle(firstGV,firstData,codim,0);
+      RankTransfer<SDGV,DataVector> secondHandle(secondGV,secondData,codim,8);
+      RankTransfer<MDGV,DataVector> gridHandle(mdgv,gridData,codim,16);
+      auto firstCommunication = first.communicateAsync(firstHandle,iftype,dir);
+      auto secondCommunication = second.communicateAsync(secondHandle,iftype,dir);
+      auto gridCommunication = grid.communicateAsync(gridHandle,iftype,dir);
+      gridCommunication.wait();
+      secondCommunication.wait();
+      firstCommunication.wait();
+
+      if (firstData != firstReference || secondData != secondReference)
+        DUNE_THROW(Dune::Exception,"overlapping asynchronous subdomain communications differ from reference for codim " << codim);
+      if (gridData != gridReference)
+        DUNE_THROW(Dune::Exception,"asynchronous MultiDomainGrid communication differs from reference for codim " << codim);
+    }
+}
+
+template<typename MDGridTraits, typename HostGrid>
 void testGrid(HostGrid& hostgrid, std::string prefix, Dune::MPIHelper& mpihelper)
 {
   const int dim = HostGrid::dimension;
-  typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::FewSubDomainsTraits<2,8> > MDGrid;
-  //typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::ArrayBasedTraits<2,8,8> > MDGrid;
+  typedef Dune::MultiDomainGrid<HostGrid,MDGridTraits> MDGrid;
 
   hostgrid.leafIndexSet().index(*hostgrid.leafGridView().template begin<0>());
 
@@ -83,6 +572,7 @@ void testGrid(HostGrid& hostgrid, std::string prefix, Dune::MPIHelper& mpihelper
   typedef typename MDGrid::SubDomainIndex SubDomainIndex;
   MDGV mdgv = grid.leafGridView();
 
+  grid.setGlobalSubDomainIndexing(true);
   grid.startSubDomainMarking();
 
   for (const auto& cell : elements(mdgv))
@@ -109,6 +599,12 @@ void testGrid(HostGrid& hostgrid, std::string prefix, Dune::MPIHelper& mpihelper
   grid.updateSubDomains();
   grid.postUpdateSubDomains();
 
+  checkGlobalIndices(mdgv);
+  checkInterfaceMapper(mdgv);
+  checkSubDomainRanks(grid);
+  checkOverlappingAsyncCommunications(grid);
+  checkHalos(grid,mpihelper.rank());
+
   for (const auto& cell : elements(mdgv))
     {
       std::cout << mpihelper.rank() << ": " << std::setw(2) << mdgv.indexSet().index(cell) << "  " << cell.geometry().center()
@@ -135,6 +631,9 @@ void testGrid(HostGrid& hostgrid, std::string prefix, Dune::MPIHelper& mpihelper
       const SDGrid& sdgrid = grid.subDomain(s);
       SDGV sdgv = sdgrid.leafGridView();
 
+      grid.subDomain(s).setHaloLayers(2);
+      checkHalo(sdgrid,mpihelper.rank());
+
       typedef std::vector<std::size_t> DataVector;
       DataVector celldata(sdgv.size(0));
       std::fill(celldata.begin(),celldata.end(),1 << mpihelper.rank());
@@ -151,6 +650,32 @@ void testGrid(HostGrid& hostgrid, std::string prefix, Dune::MPIHelper& mpihelper
 
       sdgrid.communicate(nodedatahandle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
 
+      // compare against a communication over the complete MultiDomainGrid interface
+      for (int codim : {0,dim})
+        for (auto iftype : {Dune::InteriorBorder_InteriorBorder_Interface,Dune::InteriorBorder_All_Interface,Dune::All_All_Interface})
+          for (auto dir : {Dune::ForwardCommunication,Dune::BackwardCommunication})
+            {
+              DataVector data(sdgv.size(codim),1 << mpihelper.rank());
+              DataHandle datahandle(sdgv,data,codim);
+              sdgrid.communicate(datahandle,iftype,dir);
+
+              DataVector reference(sdgv.size(codim),1 << mpihelper.rank());
+              SubDomainRankTransfer<SDGrid,DataVector> referencehandle(sdgrid,reference,codim);
+              grid.communicate(referencehandle,iftype,dir);
+
+              if (data != reference)
+                DUNE_THROW(Dune::Exception,"subdomain communication differs from reference on subdomain " << s);
+
+              // the non-blocking variant has to deliver the same data
+              DataVector asyncData(sdgv.size(codim),1 << mpihelper.rank());
+              DataHandle asyncDataHandle(sdgv,asyncData,codim);
+              auto communication = sdgrid.communicateAsync(asyncDataHandle,iftype,dir);
+              communication.test();
+              communication.wait();
+              if (asyncData != reference)
+                DUNE_THROW(Dune::Exception,"asynchronous subdomain communication differs from reference on subdomain " << s);
+            }
+
       bool dummy = false;
       for (const auto& cell : elements(sdgv))
         {
@@ -212,7 +737,20 @@ int main(int argc, char** argv)
       typedef Dune::YaspGrid<dim> HostGrid;
       HostGrid hostgrid(h,s,p,overlap);
 
-      testGrid(hostgrid,"YaspGrid_2",mpihelper);
+      testGrid<Dune::mdgrid::FewSubDomainsTraits<dim,8> >(hostgrid,"YaspGrid_2",mpihelper);
+      // communicates the subdomain sets in the variable-length encoding
+      testGrid<Dune::mdgrid::ArrayBasedTraits<dim,8,8> >(hostgrid,"YaspGrid_2_arraybased",mpihelper);
+      testUniqueInterfaces(hostgrid);
+    }
+
+    {
+      // without overlap, faces on processor boundaries are collected as remote faces
+      const Dune::FieldVector<double,dim> h(1.0);
+      std::array<int,dim> s;
+      std::fill(s.begin(), s.end(), N);
+      std::bitset<dim> p(false);
+      Dune::YaspGrid<dim> hostgrid(h,s,p,0);
+      testUniqueInterfaces(hostgrid);
     }
 
     {
@@ -227,7 +765,8 @@ int main(int argc, char** argv)
         n
         );
       gridPtr->loadBalance();
-      testGrid(*gridPtr,"UGGrid_2",mpihelper);
+      testGrid<Dune::mdgrid::FewSubDomainsTraits<2,8> >(*gridPtr,"UGGrid_2",mpihelper);
+      testGrid<Dune::mdgrid::ArrayBasedTraits<2,8,8> >(*gridPtr,"UGGrid_2_arraybased",mpihelper);
 #endif
     }
   }
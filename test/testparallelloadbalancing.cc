@@ -0,0 +1,188 @@
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/grid/uggrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+#include <dune/grid/multidomaingrid.hh>
+
+typedef Dune::UGGrid<2> HostGrid;
+typedef Dune::MultiDomainGrid<HostGrid,Dune::mdgrid::ArrayBasedTraits<2,4,1024> > MDGrid;
+typedef MDGrid::SubDomainIndex SubDomainIndex;
+
+// the subdomains of a cell, with indices that take several bytes in the wire format
+template<typename Coordinate>
+std::vector<SubDomainIndex> expectedSubDomains(const Coordinate& c)
+{
+  std::vector<SubDomainIndex> result;
+  if (c[0] < 0.5)
+    result.push_back(1);
+  if (c[1] < 0.5)
+    result.push_back(130);
+  if (c[0] + c[1] < 0.6)
+    result.push_back(1023);
+  return result;
+}
+
+// sends the rank of the sending process along with every cell and records the senders
+struct SenderDataHandle
+  : public Dune::CommDataHandleIF<SenderDataHandle,int>
+{
+
+  bool contains(int dim, int codim) const
+  {
+    return codim == 0;
+  }
+
+  bool fixedSize(int dim, int codim) const
+  {
+    return true;
+  }
+
+  template<typename Entity>
+  std::size_t size(const Entity& e) const
+  {
+    return 1;
+  }
+
+  template<typename MessageBuffer, typename Entity>
+  void gather(MessageBuffer& buf, const Entity& e) const
+  {
+    buf.write(rank);
+  }
+
+  template<typename MessageBuffer, typename Entity>
+  void scatter(MessageBuffer& buf, const Entity& e, std::size_t n)
+  {
+    // the subdomains packed in front of our data must not be counted
+    if (n != 1) {
+      std::cerr << rank << ": received " << n << " items instead of 1" << std::endl;
+      ++errors;
+    }
+    int sender;
+    buf.read(sender);
+    if (sender != rank)
+      senders.insert(sender);
+  }
+
+  explicit SenderDataHandle(int rank_)
+    : rank(rank_)
+  {}
+
+  int rank;
+  std::set<int> senders;
+  int errors = 0;
+
+};
+
+int checkSubDomains(const MDGrid& grid, const std::string& stage)
+{
+  int errors = 0;
+  const auto gv = grid.leafGridView();
+  for (const auto& cell : elements(gv)) {
+    const auto& subDomains = gv.indexSet().subDomains(cell);
+    const std::vector<SubDomainIndex> actual(subDomains.begin(),subDomains.end());
+    if (actual != expectedSubDomains(cell.geometry().center())) {
+      std::cerr << grid.comm().rank() << ": wrong subdomains of " << (cell.partitionType() == Dune::InteriorEntity ? "interior" : "ghost")
+                << " cell at " << cell.geometry().center() << " " << stage << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+// UGGrid has to take the branch of weightedLoadBalance() that passes the weighted partition
+static_assert(Dune::mdgrid::HasTargetPartitionLoadBalance<HostGrid,SenderDataHandle>::value,
+              "UGGrid cannot be balanced to a given partition");
+
+// checks that all processes carry the same weight, up to one column of the heaviest cells per bisection level
+template<typename Cost>
+int checkWeights(const MDGrid& grid, const Cost& cost, const std::string& stage)
+{
+  const auto gv = grid.leafGridView();
+  double weight = 0.0;
+  for (const auto& cell : elements(gv,Dune::Partitions::interior))
+    weight += Dune::mdgrid::subDomainWeight(cost,gv.indexSet().subDomains(cell));
+  const double total = grid.comm().sum(weight);
+  const double tolerance = 2 * 16 * 20.0;
+  if (std::abs(weight - total / grid.comm().size()) > tolerance) {
+    std::cerr << grid.comm().rank() << ": weight " << weight << " of " << total << " is unbalanced " << stage << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc,argv);
+    const int rank = mpihelper.rank();
+
+    Dune::FieldVector<double,2> lower_left(0.0);
+    Dune::FieldVector<double,2> upper_right(1.0);
+    std::array<unsigned int,2> n = {{16,16}};
+    auto hostgrid = Dune::StructuredGridFactory<HostGrid>::createCubeGrid(lower_left,upper_right,n);
+
+    MDGrid grid(*hostgrid,true);
+    auto gv = grid.leafGridView();
+
+    grid.startSubDomainMarking();
+    for (const auto& cell : elements(gv,Dune::Partitions::interior))
+      for (SubDomainIndex subDomain : expectedSubDomains(cell.geometry().center()))
+        grid.addToSubDomain(subDomain,cell);
+    grid.preUpdateSubDomains();
+    grid.updateSubDomains();
+    grid.postUpdateSubDomains();
+
+    int errors = checkSubDomains(grid,"before load balancing");
+
+    // distributes the cells, which are all created on rank 0
+    SenderDataHandle distribution(rank);
+    if (!grid.loadBalance(distribution))
+      ++errors;
+    errors += distribution.errors;
+    errors += checkSubDomains(grid,"after distributing the grid");
+
+    // migrates cells between all processes, first to a uniform partition and then to one that
+    // moves the boundaries of the first part into the parts of all other processes
+    const auto uniform = [](const auto& subDomains) { return 1.0; };
+    const auto skewed = [](const auto& subDomains) { return subDomains.contains(1) ? 1.0 : 20.0; };
+    SenderDataHandle uniformMigration(rank);
+    if (!grid.weightedLoadBalance(uniform,uniformMigration))
+      ++errors;
+    errors += uniformMigration.errors;
+    errors += checkSubDomains(grid,"after the uniform migration");
+    errors += checkWeights(grid,uniform,"after the uniform migration");
+
+    SenderDataHandle skewedMigration(rank);
+    if (!grid.weightedLoadBalance(skewed,skewedMigration))
+      ++errors;
+    errors += skewedMigration.errors;
+    errors += checkSubDomains(grid,"after the skewed migration");
+    errors += checkWeights(grid,skewed,"after the skewed migration");
+
+    // with more than two processes, the first one receives cells from several others
+    int senders = skewedMigration.senders.size();
+    senders = grid.comm().max(senders);
+    if (senders < std::min(grid.comm().size() - 1,2)) {
+      std::cerr << rank << ": no process received cells from " << std::min(grid.comm().size() - 1,2) << " processes" << std::endl;
+      ++errors;
+    }
+
+    errors = grid.comm().sum(errors);
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "Generic exception!" << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,252 @@
+#include "config.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/multidomaingrid/arraybasedset.hh>
+#include <dune/grid/multidomaingrid/subdomainsetencoding.hh>
+
+using namespace Dune::mdgrid;
+
+// message buffer that stores the written items of type T
+template<typename T>
+struct Buffer
+{
+
+  void write(const T& item)
+  {
+    items.push_back(item);
+  }
+
+  void read(T& item)
+  {
+    item = items.at(pos++);
+  }
+
+  std::vector<T> items;
+  std::size_t pos = 0;
+
+};
+
+// sorted subdomain indices that are not limited by the empty tag of ArrayBasedSet
+template<typename SI>
+struct IndexList
+{
+
+  typedef SI SubDomainIndex;
+
+  typename std::vector<SI>::const_iterator begin() const
+  {
+    return indices.begin();
+  }
+
+  typename std::vector<SI>::const_iterator end() const
+  {
+    return indices.end();
+  }
+
+  std::vector<SI> indices;
+
+};
+
+// item type whose size is not a power of two
+struct ThreeBytes
+{
+  unsigned char bytes[3];
+};
+
+template<typename T>
+int checkValue(T value, std::size_t expectedSize)
+{
+  int errors = 0;
+  Buffer<unsigned char> buf;
+  util::encodeValue(value,[&](unsigned char byte) { buf.write(byte); });
+  if (buf.items.size() != expectedSize || util::encodedSize(value) != expectedSize) {
+    std::cerr << "value " << +value << " encoded into " << buf.items.size() << " bytes instead of " << expectedSize << std::endl;
+    ++errors;
+  }
+  std::size_t consumed = 0;
+  const T decoded = util::decodeValue<T>([&]() { unsigned char byte; buf.read(byte); return byte; },consumed);
+  if (decoded != value || consumed != buf.items.size()) {
+    std::cerr << "value " << +value << " decoded as " << +decoded << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int checkValues()
+{
+  int errors = 0;
+  errors += checkValue<std::uint8_t>(0,1);
+  errors += checkValue<std::uint8_t>(127,1);
+  errors += checkValue<std::uint8_t>(128,2);
+  errors += checkValue<std::uint8_t>(std::numeric_limits<std::uint8_t>::max(),2);
+  errors += checkValue<std::uint16_t>(16383,2);
+  errors += checkValue<std::uint16_t>(16384,3);
+  errors += checkValue<std::uint16_t>(std::numeric_limits<std::uint16_t>::max(),3);
+  errors += checkValue<std::uint32_t>(std::numeric_limits<std::uint32_t>::max(),5);
+  errors += checkValue<std::uint64_t>(std::uint64_t(1) << 56,9);
+  errors += checkValue<std::uint64_t>(std::numeric_limits<std::uint64_t>::max(),10);
+
+  // the byte layout is part of the wire format
+  Buffer<unsigned char> buf;
+  util::encodeValue(300u,[&](unsigned char byte) { buf.write(byte); });
+  if (buf.items != std::vector<unsigned char>{0xac,0x02}) {
+    std::cerr << "wrong encoding of 300" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+template<typename SI>
+int checkIndexList(const std::vector<SI>& indices)
+{
+  int errors = 0;
+  IndexList<SI> list{indices};
+  Buffer<unsigned char> buf;
+  util::encodeSubDomains(list,[&](unsigned char byte) { buf.write(byte); });
+  if (buf.items.size() != util::encodedSubDomainsSize(list)) {
+    std::cerr << "encoded size of subdomain list differs from encodedSubDomainsSize()" << std::endl;
+    ++errors;
+  }
+  std::vector<SI> decoded;
+  util::decodeSubDomains<SI>(buf.items.size(),
+                             [&]() { unsigned char byte; buf.read(byte); return byte; },
+                             [&](SI subDomain) { decoded.push_back(subDomain); });
+  if (decoded != indices) {
+    std::cerr << "subdomain list of " << indices.size() << " entries differs after decoding" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int checkIndexLists()
+{
+  int errors = 0;
+  errors += checkIndexList<int>({});
+  errors += checkIndexList<int>({0});
+  errors += checkIndexList<int>({0,1,2,3});
+  errors += checkIndexList<int>({127,128,255,256,16383,16384,16385});
+  errors += checkIndexList<int>({0,std::numeric_limits<int>::max()});
+  errors += checkIndexList<std::uint16_t>({1,std::numeric_limits<std::uint16_t>::max()});
+  errors += checkIndexList<std::uint32_t>({std::numeric_limits<std::uint32_t>::max()});
+  errors += checkIndexList<std::uint64_t>({5,std::numeric_limits<std::uint64_t>::max() - 1,std::numeric_limits<std::uint64_t>::max()});
+  return errors;
+}
+
+template<typename Set>
+Set makeSet(const std::vector<typename Set::SubDomainIndex>& indices)
+{
+  Set set;
+  for (auto subDomain : indices)
+    set.add(subDomain);
+  return set;
+}
+
+// communicates an ArrayBasedSet through its own data handle
+template<typename SI>
+int checkArrayBasedSet(const std::vector<SI>& indices)
+{
+  typedef ArrayBasedSet<SI,8> Set;
+  typedef typename Set::DataHandle DataHandle;
+  int errors = 0;
+  const Set set = makeSet<Set>(indices);
+  Buffer<typename DataHandle::DataType> buf;
+  DataHandle::gather(buf,set);
+  if (buf.items.size() != DataHandle::size(set)) {
+    std::cerr << "ArrayBasedSet data handle wrote " << buf.items.size() << " items instead of " << DataHandle::size(set) << std::endl;
+    ++errors;
+  }
+  Set received;
+  DataHandle::scatter(buf,received,buf.items.size());
+  if (!(received == set)) {
+    std::cerr << "ArrayBasedSet differs after communication" << std::endl;
+    ++errors;
+  }
+  // received subdomains are added to the existing ones
+  Set merged = makeSet<Set>({2});
+  buf.pos = 0;
+  DataHandle::scatter(buf,merged,buf.items.size());
+  Set expected = set;
+  expected.add(2);
+  if (!(merged == expected)) {
+    std::cerr << "ArrayBasedSet data handle does not merge received subdomains" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+// packs several sets into items of type Item, as done during load balancing
+template<typename Item>
+int checkItems()
+{
+  typedef int SI;
+  typedef ArrayBasedSet<SI,8> Set;
+  const std::vector<std::vector<SI> > sets = {
+    {},
+    {0},
+    {1,2,3},
+    {127,128,200,16384},
+    {0,std::numeric_limits<SI>::max() - 1}
+  };
+
+  int errors = 0;
+  Buffer<Item> buf;
+  std::size_t expectedItems = 0;
+  for (const auto& indices : sets) {
+    const Set set = makeSet<Set>(indices);
+    const std::size_t before = buf.items.size();
+    util::writeSubDomainItems<Item>(buf,set);
+    if (buf.items.size() - before != util::encodedSubDomainsItems<Item>(set)) {
+      std::cerr << "wrong number of items of size " << sizeof(Item) << " for a set of " << indices.size() << " subdomains" << std::endl;
+      ++errors;
+    }
+    expectedItems += util::encodedSubDomainsItems<Item>(set);
+  }
+  if (buf.items.size() != expectedItems)
+    ++errors;
+
+  for (const auto& indices : sets) {
+    std::vector<SI> decoded;
+    const std::size_t before = buf.pos;
+    const std::size_t items = util::readSubDomainItems<Item,SI>(buf,[&](SI subDomain) { decoded.push_back(subDomain); });
+    if (items != buf.pos - before) {
+      std::cerr << "readSubDomainItems() reported " << items << " items instead of " << buf.pos - before << std::endl;
+      ++errors;
+    }
+    if (decoded != indices) {
+      std::cerr << "set of " << indices.size() << " subdomains differs after unpacking from items of size " << sizeof(Item) << std::endl;
+      ++errors;
+    }
+  }
+  if (buf.pos != buf.items.size()) {
+    std::cerr << "not all items of size " << sizeof(Item) << " were read" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    int errors = 0;
+    errors += checkValues();
+    errors += checkIndexLists();
+    errors += checkArrayBasedSet<int>({0,1,127,128,300,16384,std::numeric_limits<int>::max() - 1});
+    errors += checkArrayBasedSet<std::uint16_t>({128,std::numeric_limits<std::uint16_t>::max() - 1});
+    errors += checkArrayBasedSet<std::uint64_t>({0,std::numeric_limits<std::uint64_t>::max() - 1});
+    errors += checkItems<unsigned char>();
+    errors += checkItems<ThreeBytes>();
+    errors += checkItems<int>();
+    errors += checkItems<double>();
+    errors += checkItems<std::uint64_t>();
+    return errors > 0 ? 1 : 0;
+  } catch (Dune::Exception& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}